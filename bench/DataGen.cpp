@@ -0,0 +1,129 @@
+#include "DataGen.hpp"
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include "FileUtil.hpp"
+#include "Persistence.hpp"
+
+static const char *DISHES[] = {
+    "Falafel", "Burger", "Wrap", "Chai", "Biryani", "Samosa", "Karahi", "Paratha",
+    "Nihari", "Haleem", "Pulao", "Tikka", "Seekh Kebab", "Daal Chawal", "Halwa Puri", "Lassi",
+};
+static const int DISH_COUNT = sizeof(DISHES) / sizeof(DISHES[0]);
+static const char *CITIES[] = {"Lahore", "Karachi", "Islamabad", "Peshawar"};
+
+std::vector<Customer> DataGen::customers(const DataGenConfig &cfg) {
+    std::vector<Customer> out(cfg.customers);
+    for (long i = 0; i < cfg.customers; ++i) {
+        Customer &c = out[i];
+        c.id = 100 + (int)i;
+        c.name = "Customer " + std::to_string(c.id);
+        c.email = "c" + std::to_string(c.id) + "@example.com";
+        c.phone = "0300-" + std::to_string(1000000 + i);
+        c.password = "pass";
+        c.loyaltyPoints = (int)(i % 7) * 250; // some can use the 1000-point discount
+    }
+    return out;
+}
+
+std::vector<Owner> DataGen::owners(const DataGenConfig &cfg) {
+    std::vector<Owner> out(cfg.owners);
+    for (long i = 0; i < cfg.owners; ++i) {
+        Owner &o = out[i];
+        o.id = 200 + (int)i;
+        o.name = "Owner " + std::to_string(o.id);
+        o.email = "o" + std::to_string(o.id) + "@example.com";
+        o.phone = "0321-" + std::to_string(1000000 + i);
+        o.password = "owner";
+    }
+    return out;
+}
+
+std::vector<Restaurant> DataGen::restaurants(const DataGenConfig &cfg) {
+    std::mt19937 rng(cfg.seed);
+    std::vector<Restaurant> out(cfg.restaurants);
+    for (long i = 0; i < cfg.restaurants; ++i) {
+        Restaurant &r = out[i];
+        r.id = 1 + (int)i;
+        r.name = "Restaurant " + std::to_string(r.id);
+        r.address.line1 = "Shop " + std::to_string(r.id);
+        r.address.city = CITIES[i % 4];
+        r.address.postalCode = std::to_string(54000 + i % 1000);
+        r.ownerId = cfg.owners > 0 ? 200 + (int)(i % cfg.owners) : -1;
+        for (int m = 0; m < cfg.menuItems; ++m) {
+            MenuItem mi;
+            mi.id = m + 1;
+            mi.name = DISHES[(i + m) % DISH_COUNT];
+            // whole rupees mostly, some with paisa like real menus
+            mi.price = Money::fromPaisa((40 + (int)(rng() % 60) * 10) * 100 + (rng() % 4 == 0 ? 50 : 0));
+            r.menu.push_back(mi);
+        }
+    }
+    return out;
+}
+
+Order DataGen::order(const DataGenConfig &cfg, const std::vector<Restaurant> &restaurants, long i) {
+    // Seeded per order so any slice of the history can be regenerated on its own
+    std::mt19937 rng(cfg.seed ^ (uint32_t)(i * 2654435761u));
+    Order o;
+    o.id = 100 + (int)i;
+    o.customerId = cfg.customers > 0 ? 100 + (int)(rng() % cfg.customers) : 100;
+    if (restaurants.empty()) return o;
+    const Restaurant &r = restaurants[rng() % restaurants.size()];
+    o.restaurantId = r.id;
+    int items = 1 + (int)(rng() % 3);
+    for (int k = 0; k < items && !r.menu.empty(); ++k) {
+        const MenuItem &mi = r.menu[rng() % r.menu.size()];
+        o.items.push_back(OrderItem{mi, 1 + (int)(rng() % 4), mi.price});
+    }
+    o.place();
+    switch (rng() % 8) {
+        case 0: case 1: case 2: break; // still Placed
+        case 3: o.cancel(); break;
+        case 4: o.accept(); o.startPreparing(); break;
+        case 5: o.dispatch(); break;
+        default: o.dispatch(); o.deliver(); break;
+    }
+    return o;
+}
+
+bool DataGen::writeOrders(const DataGenConfig &cfg, const std::vector<Restaurant> &restaurants, const std::string &path) {
+    std::ofstream ofs(path, std::ios::trunc | std::ios::binary);
+    if (!ofs) return false;
+    std::string chunk;
+    uint32_t crc = 0;
+    uint64_t length = 0;
+    auto flush = [&] {
+        crc = FileUtil::crc32(chunk, crc);
+        length += chunk.size();
+        ofs.write(chunk.data(), chunk.size());
+        chunk.clear();
+    };
+    for (long i = 0; i < cfg.orders; ++i) {
+        chunk += Persistence::formatOrder(order(cfg, restaurants, i));
+        chunk += '\n';
+        if (chunk.size() >= (1 << 20)) flush();
+    }
+    flush();
+    ofs << Persistence::checksumFooter(crc, length); // same footer as saveAllOrders writes
+    return (bool)ofs;
+}
+
+bool DataGen::writeAll(const DataGenConfig &cfg) {
+    Persistence::ensureDataFolderExists();
+    const std::string &dir = Persistence::dataFolder;
+    for (const char *name : {"customers.txt", "owners.txt", "restaurants.txt", "orders.txt"}) {
+        std::filesystem::remove(dir + name);
+        std::filesystem::remove(dir + name + std::string(".seq"));
+        std::filesystem::remove(dir + name + std::string(".bak"));
+    }
+    std::filesystem::remove(dir + Persistence::orderLogName("orders.txt"));
+    std::filesystem::remove(dir + Persistence::pointsJournalName("customers.txt"));
+    std::filesystem::remove(dir + "orders.bin");
+
+    auto rs = restaurants(cfg);
+    Persistence::saveAllCustomers(customers(cfg));
+    Persistence::saveAllOwners(owners(cfg));
+    Persistence::saveAllRestaurants(rs);
+    return writeOrders(cfg, rs, dir + "orders.txt");
+}
@@ -0,0 +1,40 @@
+#ifndef DATAGEN_HPP
+#define DATAGEN_HPP
+// Synthetic data for the benchmarks: customers.txt, owners.txt, restaurants.txt
+// and orders.txt in the exact format Persistence reads, at any scale.
+// The same config and seed always produce the same files.
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Customer.hpp"
+#include "Owner.hpp"
+#include "Restaurant.hpp"
+#include "Order.hpp"
+
+struct DataGenConfig {
+    long orders = 1000;
+    long customers = 1000;
+    long owners = 20;
+    long restaurants = 50;
+    int menuItems = 8; // per restaurant
+    uint32_t seed = 42;
+};
+
+struct DataGen {
+    // Ids follow the demo data: customers from 100, owners from 200,
+    // restaurants and menu items from 1, orders from 100.
+    static std::vector<Customer> customers(const DataGenConfig &cfg);
+    static std::vector<Owner> owners(const DataGenConfig &cfg);
+    static std::vector<Restaurant> restaurants(const DataGenConfig &cfg);
+    // Order i (0-based) of the generated history; placed from the restaurants' menus,
+    // a mix of statuses (and matching versions) like a live data folder
+    static Order order(const DataGenConfig &cfg, const std::vector<Restaurant> &restaurants, long i);
+
+    // Streams cfg.orders lines to path without holding them in memory
+    static bool writeOrders(const DataGenConfig &cfg, const std::vector<Restaurant> &restaurants, const std::string &path);
+    // All four tables into Persistence::dataFolder. Clears the order log, the points
+    // journal and the id sequences, so the folder holds exactly the generated data.
+    static bool writeAll(const DataGenConfig &cfg);
+};
+
+#endif
@@ -0,0 +1,92 @@
+#include "LatencyHistogram.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+// Values below 2 * SUB_COUNT get a bucket each. Above that, the bucket is chosen by
+// the highest set bit (the power of two) and the next SUB_BITS bits below it.
+static const size_t BUCKETS = 2 * 128 + 56 * 128;
+
+LatencyHistogram::LatencyHistogram() : counts(BUCKETS, 0) {}
+
+size_t LatencyHistogram::indexOf(uint64_t value) {
+    if (value < 2 * SUB_COUNT) return (size_t)value;
+    int top = 63 - __builtin_clzll(value);
+    int shift = top - SUB_BITS;
+    return 2 * SUB_COUNT + (size_t)(shift - 1) * SUB_COUNT + (size_t)((value >> shift) - SUB_COUNT);
+}
+
+uint64_t LatencyHistogram::highestEquivalent(size_t index) {
+    if (index < 2 * SUB_COUNT) return index;
+    size_t shift = (index - 2 * SUB_COUNT) / SUB_COUNT + 1;
+    uint64_t sub = SUB_COUNT + (index - 2 * SUB_COUNT) % SUB_COUNT;
+    return ((sub + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value) {
+    counts[indexOf(value)]++;
+    total++;
+    minValue = std::min(minValue, value);
+    maxValue = std::max(maxValue, value);
+    sum += (double)value;
+    sumSquares += (double)value * (double)value;
+}
+
+void LatencyHistogram::merge(const LatencyHistogram &other) {
+    for (size_t i = 0; i < BUCKETS; ++i) counts[i] += other.counts[i];
+    total += other.total;
+    minValue = std::min(minValue, other.minValue);
+    maxValue = std::max(maxValue, other.maxValue);
+    sum += other.sum;
+    sumSquares += other.sumSquares;
+}
+
+double LatencyHistogram::mean() const { return total ? sum / total : 0.0; }
+
+double LatencyHistogram::stddev() const {
+    if (!total) return 0.0;
+    double m = mean();
+    return std::sqrt(std::max(0.0, sumSquares / total - m * m));
+}
+
+uint64_t LatencyHistogram::percentile(double p) const {
+    if (!total) return 0;
+    uint64_t rank = (uint64_t)std::ceil(std::min(100.0, std::max(0.0, p)) / 100.0 * total);
+    rank = std::max<uint64_t>(rank, 1);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(highestEquivalent(i), maxValue);
+    }
+    return maxValue;
+}
+
+void LatencyHistogram::writePercentiles(std::ostream &os, double unitScale) const {
+    char line[128];
+    os << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+    // Like HdrHistogram: 5 steps per halving of the distance to 100%
+    double p = 0.0;
+    uint64_t seen = 0;
+    size_t i = 0;
+    while (total) {
+        uint64_t rank = std::max<uint64_t>((uint64_t)std::ceil(p / 100.0 * total), 1);
+        while (seen < rank && i < BUCKETS) seen += counts[i++];
+        uint64_t value = std::min(highestEquivalent(i - 1), maxValue);
+        if (seen >= total) {
+            std::snprintf(line, sizeof(line), "%12.3f %1.12f %10llu\n", value / unitScale, 1.0, (unsigned long long)seen);
+            os << line;
+            break;
+        }
+        std::snprintf(line, sizeof(line), "%12.3f %1.12f %10llu %14.2f\n", value / unitScale, p / 100.0,
+                      (unsigned long long)seen, 1.0 / (1.0 - p / 100.0));
+        os << line;
+        double halvings = std::floor(std::log2(100.0 / (100.0 - p)));
+        p += 100.0 / (5.0 * std::pow(2.0, halvings + 1));
+    }
+    std::snprintf(line, sizeof(line), "#[Mean    = %12.3f, StdDeviation   = %12.3f]\n", mean() / unitScale, stddev() / unitScale);
+    os << line;
+    std::snprintf(line, sizeof(line), "#[Max     = %12.3f, Total count    = %12llu]\n", maxValue / unitScale, (unsigned long long)total);
+    os << line;
+    std::snprintf(line, sizeof(line), "#[Buckets = %12zu, SubBuckets     = %12llu]\n", BUCKETS, (unsigned long long)SUB_COUNT);
+    os << line;
+}
@@ -0,0 +1,44 @@
+#ifndef LATENCYHISTOGRAM_HPP
+#define LATENCYHISTOGRAM_HPP
+// HDR-style latency histogram: log-linear buckets with 128 sub-buckets per power
+// of two, so every recorded value is kept to within 1/128 (< 0.8%) from 1 ns up
+// to hours, in a fixed 58 KiB of counters. Recording is O(1) and allocation free;
+// give each thread its own histogram and merge them at the end.
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    void record(uint64_t value);
+    void merge(const LatencyHistogram &other);
+
+    uint64_t count() const { return total; }
+    uint64_t min() const { return total ? minValue : 0; }
+    uint64_t max() const { return maxValue; }
+    double mean() const;
+    double stddev() const;
+    // Smallest bucket bound that covers percentile p (0..100) of the recorded values
+    uint64_t percentile(double p) const;
+
+    // Percentile distribution in HdrHistogram's .hgrm text layout (plottable with
+    // its percentile plotter); values are divided by unitScale, e.g. 1000 for us
+    void writePercentiles(std::ostream &os, double unitScale) const;
+
+private:
+    static const int SUB_BITS = 7;
+    static const uint64_t SUB_COUNT = 1u << SUB_BITS;
+    static size_t indexOf(uint64_t value);
+    static uint64_t highestEquivalent(size_t index); // largest value that lands in the bucket
+
+    std::vector<uint64_t> counts;
+    uint64_t total = 0;
+    uint64_t minValue = UINT64_MAX;
+    uint64_t maxValue = 0;
+    double sum = 0.0;
+    double sumSquares = 0.0;
+};
+
+#endif
@@ -0,0 +1,40 @@
+// Load-throughput benchmark for the text data files.
+// Generates an orders.txt with N orders (default 1M) in a scratch data folder
+// and reports how fast Persistence::loadAllOrders parses it.
+//
+//   sustieats_bench_load [orders] [scratchDir] [runs]
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include "DataGen.hpp"
+#include "Persistence.hpp"
+
+int main(int argc, char **argv) {
+    long count = argc > 1 ? std::stol(argv[1]) : 1000000;
+    std::string dir = argc > 2 ? argv[2] : (std::filesystem::temp_directory_path() / "sustieats_bench_load").string();
+    int runs = argc > 3 ? std::stoi(argv[3]) : 3;
+    if (dir.back() != '/') dir += '/';
+
+    std::filesystem::create_directories(dir);
+    Persistence::dataFolder = dir;
+    std::filesystem::remove(dir + Persistence::orderLogName("orders.txt"));
+    DataGenConfig cfg;
+    cfg.orders = count;
+    cfg.customers = 5000;
+    if (!DataGen::writeOrders(cfg, DataGen::restaurants(cfg), dir + "orders.txt")) { std::cerr << "Could not write " << dir << "orders.txt\n"; return 1; }
+    double mb = std::filesystem::file_size(dir + "orders.txt") / (1024.0 * 1024.0);
+    std::cout << "orders.txt: " << count << " orders, " << mb << " MB\n";
+
+    double best = 1e30;
+    for (int r = 0; r < runs; ++r) {
+        auto t0 = std::chrono::steady_clock::now();
+        auto orders = Persistence::loadAllOrders();
+        double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        if ((long)orders.size() != count) { std::cerr << "loaded " << orders.size() << " orders, expected " << count << "\n"; return 1; }
+        std::cout << "run " << r + 1 << ": " << secs * 1000.0 << " ms, " << mb / secs << " MB/s\n";
+        if (secs < best) best = secs;
+    }
+    std::cout << "loadAllOrders best: " << mb / best << " MB/s, " << count / best / 1e6 << " M orders/s\n";
+    return 0;
+}
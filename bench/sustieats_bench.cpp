@@ -0,0 +1,219 @@
+// Persistence micro-benchmarks on generated data (see DataGen.hpp).
+// Times loadAll*, saveAll*, saveOrder, getNextId and LoyaltyManager::processCheckout
+// and prints the results as JSON, so runs can be compared release over release.
+//
+//   sustieats_bench [--orders N] [--customers N] [--owners N] [--restaurants N]
+//                   [--dir DIR] [--out FILE] [--min-time SECONDS] [--max-iters N]
+//                   [--filter TEXT] [--seed N]
+//
+// Each benchmark repeats until it has run for --min-time (default 0.5 s) or
+// --max-iters times (default 1000), at least once. The data folder is scratch:
+// it is regenerated on every run and the append benchmarks leave it changed.
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "DataGen.hpp"
+#include "LoyaltyManager.hpp"
+#include "Persistence.hpp"
+
+struct BenchOptions {
+    DataGenConfig data;
+    std::string dir;
+    std::string out;
+    std::string filter;
+    double minTime = 0.5;
+    long maxIters = 1000;
+};
+
+struct BenchResult {
+    std::string name;
+    long rows = 0;        // rows handled by one iteration
+    uint64_t bytes = 0;   // size of the file read or written by one iteration, 0 if not meaningful
+    std::vector<double> ns; // one entry per iteration
+};
+
+using Clock = std::chrono::steady_clock;
+
+static uint64_t fileSize(const std::string &name) {
+    std::error_code ec;
+    auto n = std::filesystem::file_size(Persistence::dataFolder + name, ec);
+    return ec ? 0 : n;
+}
+
+// prepare runs before every iteration and is not timed
+static BenchResult measure(const BenchOptions &opt, const std::string &name, long rows,
+                           const std::function<void()> &body, const std::function<void()> &prepare = nullptr) {
+    BenchResult r;
+    r.name = name;
+    r.rows = rows;
+    double spent = 0.0;
+    while (r.ns.empty() || (spent < opt.minTime && (long)r.ns.size() < opt.maxIters)) {
+        if (prepare) prepare();
+        auto t0 = Clock::now();
+        body();
+        double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        r.ns.push_back(secs * 1e9);
+        spent += secs;
+    }
+    return r;
+}
+
+static double percentile(const std::vector<double> &sorted, double p) {
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+static void writeJson(std::ostream &os, const BenchOptions &opt, const std::vector<BenchResult> &results) {
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+#ifdef NDEBUG
+    const char *build = "release";
+#else
+    const char *build = "debug";
+#endif
+    os << "{\n  \"context\": {\n"
+       << "    \"date\": \"" << date << "\",\n"
+       << "    \"compiler\": \"" << __VERSION__ << "\",\n"
+       << "    \"build\": \"" << build << "\",\n"
+       << "    \"orders\": " << opt.data.orders << ",\n"
+       << "    \"customers\": " << opt.data.customers << ",\n"
+       << "    \"owners\": " << opt.data.owners << ",\n"
+       << "    \"restaurants\": " << opt.data.restaurants << ",\n"
+       << "    \"menu_items\": " << opt.data.menuItems << ",\n"
+       << "    \"seed\": " << opt.data.seed << ",\n"
+       << "    \"min_time_s\": " << opt.minTime << "\n"
+       << "  },\n  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchResult &r = results[i];
+        std::vector<double> s = r.ns;
+        std::sort(s.begin(), s.end());
+        double mean = 0.0;
+        for (double v : s) mean += v;
+        mean /= s.size();
+        double median = percentile(s, 0.5);
+        os << (i ? "," : "") << "\n    {\n"
+           << "      \"name\": \"" << r.name << "\",\n"
+           << "      \"iterations\": " << s.size() << ",\n"
+           << "      \"rows\": " << r.rows << ",\n"
+           << "      \"bytes\": " << r.bytes << ",\n"
+           << "      \"mean_ns\": " << (long long)mean << ",\n"
+           << "      \"min_ns\": " << (long long)s.front() << ",\n"
+           << "      \"median_ns\": " << (long long)median << ",\n"
+           << "      \"p90_ns\": " << (long long)percentile(s, 0.90) << ",\n"
+           << "      \"p99_ns\": " << (long long)percentile(s, 0.99) << ",\n"
+           << "      \"max_ns\": " << (long long)s.back() << ",\n"
+           << "      \"rows_per_sec\": " << r.rows / (median / 1e9) << ",\n"
+           << "      \"mb_per_sec\": " << r.bytes / (1024.0 * 1024.0) / (median / 1e9) << "\n"
+           << "    }";
+    }
+    os << "\n  ]\n}\n";
+}
+
+static void printUsage() {
+    std::cerr << "usage: sustieats_bench [--orders N] [--customers N] [--owners N] [--restaurants N] [--dir DIR]\n"
+                 "                       [--out FILE] [--min-time SECONDS] [--max-iters N] [--filter TEXT] [--seed N]\n";
+}
+
+static bool parseArgs(int argc, char **argv, BenchOptions &opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) { printUsage(); return false; }
+        std::string v = argv[++i];
+        if (a == "--orders") opt.data.orders = std::stol(v);
+        else if (a == "--customers") opt.data.customers = std::stol(v);
+        else if (a == "--owners") opt.data.owners = std::stol(v);
+        else if (a == "--restaurants") opt.data.restaurants = std::stol(v);
+        else if (a == "--dir") opt.dir = v;
+        else if (a == "--out") opt.out = v;
+        else if (a == "--min-time") opt.minTime = std::stod(v);
+        else if (a == "--max-iters") opt.maxIters = std::stol(v);
+        else if (a == "--filter") opt.filter = v;
+        else if (a == "--seed") opt.data.seed = (uint32_t)std::stoul(v);
+        else { printUsage(); return false; }
+    }
+    return true;
+}
+
+int main(int argc, char **argv) {
+    BenchOptions opt;
+    try {
+        if (!parseArgs(argc, argv, opt)) return 2;
+    } catch (const std::exception &) { printUsage(); return 2; }
+    if (opt.dir.empty()) opt.dir = (std::filesystem::temp_directory_path() / "sustieats_bench").string();
+    if (opt.dir.back() != '/') opt.dir += '/';
+
+    std::filesystem::create_directories(opt.dir);
+    Persistence::dataFolder = opt.dir;
+    auto t0 = Clock::now();
+    if (!DataGen::writeAll(opt.data)) { std::cerr << "Could not write data to " << opt.dir << "\n"; return 1; }
+    std::cerr << "generated " << opt.data.orders << " orders in "
+              << std::chrono::duration<double>(Clock::now() - t0).count() << " s (" << opt.dir << ")\n";
+
+    std::vector<BenchResult> results;
+    auto run = [&](const std::string &name, long rows, const std::string &file, const std::function<void()> &body,
+                   const std::function<void()> &prepare = nullptr) {
+        if (!opt.filter.empty() && name.find(opt.filter) == std::string::npos) return;
+        results.push_back(measure(opt, name, rows, body, prepare));
+        results.back().bytes = file.empty() ? 0 : fileSize(file);
+        std::cerr << name << ": " << results.back().ns.size() << " iterations\n";
+    };
+
+    // Reads first, while the folder holds exactly the generated data
+    auto customers = Persistence::loadAllCustomers();
+    auto owners = Persistence::loadAllOwners();
+    auto restaurants = Persistence::loadAllRestaurants();
+    auto orders = Persistence::loadAllOrders();
+    run("loadAllCustomers", (long)customers.size(), "customers.txt", [] { Persistence::loadAllCustomers(); });
+    run("loadAllOwners", (long)owners.size(), "owners.txt", [] { Persistence::loadAllOwners(); });
+    run("loadAllRestaurants", (long)restaurants.size(), "restaurants.txt", [] { Persistence::loadAllRestaurants(); });
+    run("loadAllOrders", (long)orders.size(), "orders.txt", [] { Persistence::loadAllOrders(); });
+    run("getNextId", (long)orders.size(), "orders.txt", [] { Persistence::getNextId("orders.txt"); });
+
+    // Rewrites of the same rows, so the data stays as generated
+    run("saveAllCustomers", (long)customers.size(), "customers.txt", [&] { Persistence::saveAllCustomers(customers); });
+    run("saveAllOwners", (long)owners.size(), "owners.txt", [&] { Persistence::saveAllOwners(owners); });
+    run("saveAllRestaurants", (long)restaurants.size(), "restaurants.txt", [&] { Persistence::saveAllRestaurants(restaurants); });
+    run("saveAllOrders", (long)orders.size(), "orders.txt", [&] { Persistence::saveAllOrders(orders); });
+
+    // Appends. Compaction rewrites the whole table and is already covered by
+    // saveAllOrders, so it is held off here to time the append itself.
+    size_t compactBytes = Persistence::orderLogCompactBytes;
+    Persistence::orderLogCompactBytes = SIZE_MAX;
+    long next = opt.data.orders;
+    run("saveOrder", 1, "", [&] {
+        Order o = DataGen::order(opt.data, restaurants, next);
+        o.id = 100 + (int)next++;
+        Persistence::saveOrder(o);
+    });
+
+    // One cart over two restaurants per checkout; building the cart is not timed
+    Customer shopper = customers.empty() ? Customer() : std::move(customers.front());
+    std::vector<Order> cartOrders;
+    run("processCheckout", 2, "", [&] { LoyaltyManager::processCheckout(shopper, cartOrders, false); }, [&] {
+        for (size_t k = 0; k < 2 && k < restaurants.size(); ++k) {
+            const Restaurant &r = restaurants[(next + k) % restaurants.size()];
+            for (size_t m = 0; m < 2 && m < r.menu.size(); ++m) shopper.addToCart(r.menu[m], 1 + (int)m, r.id, r.name);
+        }
+        next++;
+        cartOrders = shopper.checkout();
+    });
+    Persistence::orderLogCompactBytes = compactBytes;
+
+    if (opt.out.empty()) {
+        writeJson(std::cout, opt, results);
+    } else {
+        std::ofstream ofs(opt.out, std::ios::trunc);
+        writeJson(ofs, opt, results);
+        if (!ofs) { std::cerr << "Could not write " << opt.out << "\n"; return 1; }
+        std::cerr << "wrote " << opt.out << "\n";
+    }
+    return 0;
+}
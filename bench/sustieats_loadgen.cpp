@@ -0,0 +1,196 @@
+// Checkout load generator: N threads, each a customer who keeps filling a cart
+// across several restaurants (Customer::addToCart) and checking out
+// (Customer::checkout + LoyaltyManager::processCheckout) against a scratch data
+// folder, like N terminals at lunch time. Reports checkout latency percentiles
+// from HDR-style histograms, orders/s, and bytes written per order.
+//
+//   sustieats_loadgen [--threads N] [--seconds S | --checkouts N] [--restaurants-per-cart N]
+//                     [--history N] [--customers N] [--restaurants N] [--dir DIR] [--hgrm FILE]
+//                     [--trace FILE] [--metrics FILE]
+//
+// --checkouts is per thread and overrides --seconds. --history is the number of
+// orders already on disk when the run starts. --hgrm writes the full percentile
+// distribution (microseconds) in HdrHistogram's format. --trace writes the
+// SE_TRACE_* scopes of the run as a Chrome trace (keep the run short: every
+// checkout adds about a dozen events per thread). --metrics writes the
+// operational metrics (Prometheus text format) after the run.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DataGen.hpp"
+#include "LatencyHistogram.hpp"
+#include "LoyaltyManager.hpp"
+#include "Metrics.hpp"
+#include "Persistence.hpp"
+#include "Trace.hpp"
+
+struct LoadOptions {
+    DataGenConfig data;
+    int threads = 8;
+    double seconds = 10.0;
+    long checkouts = 0; // per thread; 0 = run for seconds
+    int restaurantsPerCart = 3;
+    std::string dir;
+    std::string hgrm;
+    std::string trace;
+    std::string metrics;
+};
+
+struct WorkerResult {
+    LatencyHistogram latency; // ns per checkout
+    long checkouts = 0;
+    long orders = 0;
+    long failed = 0; // checkouts whose orders could not be saved
+};
+
+using Clock = std::chrono::steady_clock;
+
+// Bytes this process passed to write() so far (Linux), -1 where unavailable.
+// Counts everything Persistence writes, compaction rewrites included.
+static long long bytesWritten() {
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    long long value;
+    while (io >> key >> value) if (key == "wchar:") return value;
+    return -1;
+}
+
+static long long folderBytes(const std::string &dir) {
+    long long n = 0;
+    std::error_code ec;
+    for (const auto &e : std::filesystem::directory_iterator(dir, ec))
+        if (e.is_regular_file(ec)) n += (long long)e.file_size(ec);
+    return n;
+}
+
+static void worker(const LoadOptions &opt, const std::vector<Restaurant> &restaurants, Customer customer, int seed,
+                   const Clock::time_point &deadline, std::atomic<bool> &go, WorkerResult &out) {
+    std::mt19937 rng(seed);
+    std::vector<size_t> picks(restaurants.size());
+    for (size_t i = 0; i < picks.size(); ++i) picks[i] = i;
+    int perCart = std::min<int>(opt.restaurantsPerCart, (int)restaurants.size());
+
+    while (!go.load(std::memory_order_acquire)) std::this_thread::yield(); // deadline is set before go
+    while (opt.checkouts ? out.checkouts < opt.checkouts : Clock::now() < deadline) {
+        // Cart over perCart different restaurants, 1-3 lines each (not timed: that is the customer browsing)
+        for (int k = 0; k < perCart; ++k) {
+            std::swap(picks[k], picks[k + rng() % (picks.size() - k)]);
+            const Restaurant &r = restaurants[picks[k]];
+            int lines = 1 + (int)(rng() % 3);
+            for (int l = 0; l < lines && !r.menu.empty(); ++l)
+                customer.addToCart(r.menu[rng() % r.menu.size()], 1 + (int)(rng() % 3), r.id, r.name);
+        }
+
+        auto t0 = Clock::now();
+        std::vector<Order> orders = customer.checkout();
+        bool saved = LoyaltyManager::processCheckout(customer, orders, false);
+        auto t1 = Clock::now();
+
+        out.latency.record((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        out.checkouts++;
+        if (saved) out.orders += (long)orders.size();
+        else out.failed++;
+    }
+}
+
+static void printUsage() {
+    std::cerr << "usage: sustieats_loadgen [--threads N] [--seconds S | --checkouts N] [--restaurants-per-cart N]\n"
+                 "                         [--history N] [--customers N] [--restaurants N] [--dir DIR] [--hgrm FILE]\n"
+                 "                         [--trace FILE] [--metrics FILE]\n";
+}
+
+// False on a bad argument; main prints the usage
+static bool parseArgs(int argc, char **argv, LoadOptions &opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) return false;
+        std::string v = argv[++i];
+        if (a == "--threads") opt.threads = std::stoi(v);
+        else if (a == "--seconds") opt.seconds = std::stod(v);
+        else if (a == "--checkouts") opt.checkouts = std::stol(v);
+        else if (a == "--restaurants-per-cart") opt.restaurantsPerCart = std::stoi(v);
+        else if (a == "--history") opt.data.orders = std::stol(v);
+        else if (a == "--customers") opt.data.customers = std::stol(v);
+        else if (a == "--restaurants") opt.data.restaurants = std::stol(v);
+        else if (a == "--dir") opt.dir = v;
+        else if (a == "--hgrm") opt.hgrm = v;
+        else if (a == "--trace") opt.trace = v;
+        else if (a == "--metrics") opt.metrics = v;
+        else return false;
+    }
+    return opt.threads > 0 && opt.restaurantsPerCart > 0;
+}
+
+int main(int argc, char **argv) {
+    LoadOptions opt;
+    opt.data.orders = 10000;
+    try {
+        if (!parseArgs(argc, argv, opt)) { printUsage(); return 2; }
+    } catch (const std::exception &) { printUsage(); return 2; }
+    opt.data.customers = std::max<long>(opt.data.customers, opt.threads); // one customer per thread
+    if (opt.dir.empty()) opt.dir = (std::filesystem::temp_directory_path() / "sustieats_loadgen").string();
+    if (opt.dir.back() != '/') opt.dir += '/';
+
+    std::filesystem::create_directories(opt.dir);
+    Persistence::dataFolder = opt.dir;
+    if (!DataGen::writeAll(opt.data)) { std::cerr << "Could not write data to " << opt.dir << "\n"; return 1; }
+    auto restaurants = Persistence::loadAllRestaurants();
+    auto customers = Persistence::loadAllCustomers();
+    if (restaurants.empty() || customers.empty()) { std::cerr << "No generated data in " << opt.dir << "\n"; return 1; }
+
+    std::vector<WorkerResult> results(opt.threads);
+    std::vector<std::thread> threads;
+    std::atomic<bool> go{false};
+    Clock::time_point deadline;
+    for (int t = 0; t < opt.threads; ++t)
+        threads.emplace_back(worker, std::cref(opt), std::cref(restaurants), std::move(customers[t]), 1000 + t,
+                             std::cref(deadline), std::ref(go), std::ref(results[t]));
+
+    long long bytesBefore = folderBytes(opt.dir);
+    long long writtenBefore = bytesWritten();
+    if (!opt.trace.empty()) Trace::startCapture();
+    auto t0 = Clock::now();
+    deadline = t0 + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opt.seconds));
+    go.store(true, std::memory_order_release);
+    for (auto &th : threads) th.join();
+    double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+    Trace::stopCapture();
+    long long written = bytesWritten();
+    long long bytesAfter = folderBytes(opt.dir);
+
+    LatencyHistogram all;
+    long checkouts = 0, orders = 0, failed = 0;
+    for (const auto &r : results) {
+        all.merge(r.latency);
+        checkouts += r.checkouts;
+        orders += r.orders;
+        failed += r.failed;
+    }
+    if (failed) std::cerr << failed << " checkouts could not be saved\n";
+    if (orders == 0) { std::cerr << "No checkouts completed\n"; return 1; }
+
+    std::cout << "threads " << opt.threads << ", " << checkouts << " checkouts (" << orders << " orders) in " << secs << " s\n";
+    std::cout << "throughput: " << orders / secs << " orders/s, " << checkouts / secs << " checkouts/s\n";
+    std::cout << "checkout latency (us): p50 " << all.percentile(50) / 1e3 << "  p99 " << all.percentile(99) / 1e3
+              << "  p999 " << all.percentile(99.9) / 1e3 << "  max " << all.max() / 1e3
+              << "  mean " << all.mean() / 1e3 << "\n";
+    std::cout << "bytes/order: ";
+    if (writtenBefore >= 0 && written >= 0) std::cout << (double)(written - writtenBefore) / orders << " written, ";
+    std::cout << (double)(bytesAfter - bytesBefore) / orders << " data growth\n";
+
+    if (!opt.trace.empty() && !Trace::writeChromeTrace(opt.trace)) return 1;
+    if (!opt.metrics.empty() && !Metrics::writeFile(opt.metrics)) return 1;
+    if (!opt.hgrm.empty()) {
+        std::ofstream ofs(opt.hgrm, std::ios::trunc);
+        all.writePercentiles(ofs, 1e3);
+        if (!ofs) { std::cerr << "Could not write " << opt.hgrm << "\n"; return 1; }
+    }
+    return 0;
+}
@@ -1,13 +1,13 @@
-#ifndef ADDRESS_HPP
-#define ADDRESS_HPP
-#include <string>
-using namespace std;
-
-struct Address
-{
-    string line1;
-    string city;
-    string postalCode;
-};
-
+#ifndef ADDRESS_HPP
+#define ADDRESS_HPP
+#include <string>
+using namespace std;
+
+struct Address
+{
+    string line1;
+    string city;
+    string postalCode;
+};
+
 #endif
\ No newline at end of file
@@ -1,13 +1,13 @@
-#ifndef ADMIN_HPP
-#define ADMIN_HPP
-#include "User.hpp"
-#include <string>
-
-class Admin : public User
-{
-public:
-    Admin() = default;
-    void disableUser(int userId);
-};
-
-#endif
+#ifndef ADMIN_HPP
+#define ADMIN_HPP
+#include "User.hpp"
+#include <string>
+
+class Admin : public User
+{
+public:
+    Admin() = default;
+    void disableUser(int userId);
+};
+
+#endif
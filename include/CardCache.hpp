@@ -0,0 +1,93 @@
+#ifndef CARDCACHE_HPP
+#define CARDCACHE_HPP
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+#include "Order.hpp"
+
+// Retained-mode widgets for the owner (screen 6) and admin (screen 7) dashboards.
+// A card builds its geometry (one vertex array for the boxes plus its sf::Text
+// objects) once, in local coordinates, and is then drawn every frame with a
+// translation. Caches rebuild a card only when what it shows has changed.
+
+class OrderCard : public sf::Drawable
+{
+public:
+    void build(const Order &o, const sf::Font &font);
+
+    float height() const { return cardHeight; }
+    bool hasButtons() const { return buttons; }
+    // local-space bounds, valid when hasButtons()
+    sf::FloatRect dispatchButton() const { return dispatchRect; }
+    sf::FloatRect cancelButton() const { return cancelRect; }
+
+    OrderStatus builtStatus = OrderStatus::Placed;
+
+private:
+    void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
+
+    sf::VertexArray shapes;
+    sf::Text info, status, total, items, dispatchLabel, cancelLabel;
+    float cardHeight = 0.f;
+    bool buttons = false;
+    sf::FloatRect dispatchRect, cancelRect;
+};
+
+class OrderCardCache
+{
+public:
+    explicit OrderCardCache(const sf::Font &font) : font(font) {}
+    // Card for the order, rebuilt only if it is new or its status changed
+    const OrderCard &get(const Order &o);
+    // Drops every card not asked for since the previous call. Called once per frame,
+    // so the cache only holds the visible cards: orders scrolled out of view, or gone
+    // after a reload, do not pile up for the whole session.
+    void evictUnused();
+    void clear() { cards.clear(); }
+
+private:
+    struct Entry
+    {
+        OrderCard card;
+        bool used = false;
+    };
+    const sf::Font &font;
+    std::unordered_map<uint64_t, Entry> cards; // by Order::key()
+};
+
+class UserRowCard : public sf::Drawable
+{
+public:
+    void build(int id, const std::string &name, bool active, const sf::Font &font);
+
+    float height() const { return 50.f; }
+    sf::FloatRect toggleButton() const { return buttonRect; }
+
+    std::string builtName;
+    bool builtActive = true;
+
+private:
+    void draw(sf::RenderTarget &target, sf::RenderStates states) const override;
+
+    sf::VertexArray shapes;
+    sf::Text info, label;
+    sf::FloatRect buttonRect;
+};
+
+class UserRowCache
+{
+public:
+    explicit UserRowCache(const sf::Font &font) : font(font) {}
+    // Row for the user, rebuilt only if it is new or its name / active flag changed
+    const UserRowCard &get(int id, const std::string &name, bool active, bool isOwner);
+
+private:
+    const sf::Font &font;
+    std::unordered_map<uint64_t, UserRowCard> rows; // by (isOwner, id)
+};
+
+// Outline drawn around the hovered button; not cached, at most one per frame
+void drawHoverOutline(sf::RenderTarget &target, const sf::FloatRect &rect, float yOffset);
+
+#endif
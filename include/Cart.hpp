@@ -1,28 +1,43 @@
-#ifndef CART_HPP
-#define CART_HPP
-#include "MenuItem.hpp"
-#include <vector>
-#include <string>
-using namespace std;
-
-struct CartItem
-{
-    MenuItem item;
-    int qty = 1;
-    int restaurantId = -1;
-    string restaurantName;
-    double subtotal() const { return item.price * qty; }
-};
-
-class Cart
-{
-public:
-    int id = 0;
-    vector<CartItem> items; // items in the cart
-    void addItem(const MenuItem &mi, int qty, int restId, const string &restName);
-    void removeItem(int menuId);
-    double getTotal() const;
-    void clear();
-};
-
-#endif
\ No newline at end of file
+#ifndef CART_HPP
+#define CART_HPP
+#include "MenuItem.hpp"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+struct CartItem
+{
+    MenuItem item;
+    int qty = 1;
+    int restaurantId = -1;
+    Symbol restaurantName;
+    Money subtotal() const { return item.price * qty; }
+};
+
+// Lines are indexed by (restaurantId, menuId) and the total is kept up to date,
+// so add/remove/total are O(1) however long the cart gets. Edit the lines only
+// through the member functions; items() is read-only for that reason.
+class Cart
+{
+public:
+    int id = 0;
+    const vector<CartItem> &items() const { return lines; } // items in the cart
+    bool empty() const { return lines.empty(); }
+    void addItem(const MenuItem &mi, int qty, int restId, Symbol restName);
+    void removeItem(int restId, int menuId); // O(1); the last line takes the removed one's place
+    void removeItem(int menuId);             // from every restaurant, O(lines)
+    Money getTotal() const { return total; }
+    void clear();
+
+private:
+    vector<CartItem> lines;
+    unordered_map<uint64_t, size_t> byKey; // (restaurantId, menuId) -> index in lines
+    Money total;
+
+    static uint64_t makeKey(int restId, int menuId) { return ((uint64_t)(uint32_t)restId << 32) | (uint32_t)menuId; }
+    void eraseAt(size_t i);
+};
+
+#endif
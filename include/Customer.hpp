@@ -1,34 +1,36 @@
-#ifndef CUSTOMER_HPP
-#define CUSTOMER_HPP
-#include "User.hpp"
-#include "Address.hpp"
-#include "Cart.hpp"
-#include <memory>
-#include <vector>
-using namespace std;
-
-class Order;
-
-class Customer : public User
-{
-public:
-    Address address;
-    int loyaltyPoints = 0;
-    unique_ptr<Cart> cart; // Customer's shopping cart
-    vector<int> orderIds; // IDs of past orders
-    Customer();
-    Customer(const Customer &other);
-    Customer &operator=(const Customer &other);
-    Customer(Customer &&) = default;
-    Customer &operator=(Customer &&) = default;
-    void addToCart(const MenuItem &mi, int qty, int restId, const string &restName);
-    vector<shared_ptr<Order>> checkout(); // returns list of orders placed
-
-    vector<int> viewOrders() const;
-    void applyPointsToOrder(int orderId);
-    void consumePoints(int pts);
-    void displayDashboard() override;
-    ~Customer() = default;
-};
-
+#ifndef CUSTOMER_HPP
+#define CUSTOMER_HPP
+#include "User.hpp"
+#include "Address.hpp"
+#include "Cart.hpp"
+#include "Order.hpp"
+#include <memory>
+#include <vector>
+#include <type_traits>
+using namespace std;
+
+class Customer : public User
+{
+public:
+    Address address;
+    int loyaltyPoints = 0;
+    unique_ptr<Cart> cart; // Customer's shopping cart, created by the first addToCart (null until then)
+    vector<int> orderIds; // IDs of past orders
+    Customer() = default;
+    Customer(const Customer &other);
+    Customer &operator=(const Customer &other);
+    Customer(Customer &&) = default;
+    Customer &operator=(Customer &&) = default;
+    void addToCart(const MenuItem &mi, int qty, int restId, Symbol restName);
+    vector<Order> checkout(); // returns the orders placed, one per restaurant
+
+    vector<int> viewOrders() const;
+    void applyPointsToOrder(int orderId);
+    void consumePoints(int pts);
+    void displayDashboard() override;
+    ~Customer() = default;
+};
+// vector<Customer> only moves rows when it grows if this holds; otherwise it deep-copies every cart
+static_assert(is_nothrow_move_constructible<Customer>::value, "Customer must be nothrow movable");
+
 #endif
\ No newline at end of file
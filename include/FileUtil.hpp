@@ -0,0 +1,92 @@
+#ifndef FILEUTIL_HPP
+#define FILEUTIL_HPP
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+using namespace std;
+
+// Identity of a file at one point in time: a rewrite or replacement changes
+// the inode or mtime, an append changes the size.
+struct FileStamp
+{
+    bool exists = false;
+    uintmax_t size = 0;
+    long long mtimeNs = 0;
+    unsigned long long inode = 0;
+    bool operator==(const FileStamp &o) const { return exists == o.exists && size == o.size && mtimeNs == o.mtimeNs && inode == o.inode; }
+    bool operator!=(const FileStamp &o) const { return !(*this == o); }
+};
+
+// Small OS-level helpers used by Persistence when iostreams are not enough
+// (durable appends, file sizes).
+struct FileUtil
+{
+    // append data to the file (created if missing) and fsync it before returning
+    // returns false if the file could not be opened or written
+    // sharedLock: hold a shared flock while appending, so a FileLock(path, true)
+    // holder (e.g. a compaction) never sees a half-folded file
+    static bool appendDurable(const string &path, const string &data, bool sharedLock = false);
+
+    // size in bytes, or 0 if the file does not exist
+    static uintmax_t fileSize(const string &path);
+
+    static FileStamp stamp(const string &path);
+
+    // bytes from offset to the end of the file ("" if missing or shorter)
+    static string readFrom(const string &path, uintmax_t offset);
+
+    // Read-modify-write of a small file under an exclusive advisory lock (flock),
+    // so concurrent processes see each update in turn. update() gets the current
+    // contents ("" for a new file) and returns the new contents, which are fsynced.
+    static bool updateLocked(const string &path, const function<string(const string &)> &update);
+
+    // Replaces the whole file so that readers, and a crash at any point, see
+    // either the old or the new contents: writes a uniquely named temp file
+    // (path.tmpXXXXXX, so concurrent savers never share one) in one go, fsyncs
+    // it, renames it over path and fsyncs the folder.
+    // keepBackup: the previous contents stay behind as path.bak (a hard link, not a copy)
+    static bool replaceDurable(const string &path, string_view data, bool keepBackup = false);
+
+    // CRC-32 (the zlib / PNG one); pass the previous result to checksum data in pieces
+    static uint32_t crc32(string_view data, uint32_t crc = 0);
+};
+
+// Advisory lock (flock) on a file, held for the lifetime of the object.
+// The file is created if missing. No-op on Windows.
+class FileLock
+{
+public:
+    FileLock(const string &path, bool exclusive);
+    ~FileLock();
+    FileLock(const FileLock &) = delete;
+    FileLock &operator=(const FileLock &) = delete;
+    bool locked() const { return fd >= 0; }
+
+private:
+    int fd = -1;
+};
+
+// Read-only view of a whole file, memory-mapped where the OS supports it.
+// A missing file gives isOpen() == false; an empty file gives an empty view.
+class MappedFile
+{
+public:
+    explicit MappedFile(const string &path);
+    ~MappedFile();
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool isOpen() const { return opened; }
+    string_view view() const { return string_view(ptr, len); }
+
+private:
+    const char *ptr = nullptr;
+    size_t len = 0;
+    bool opened = false;
+    bool mapped = false;
+    string fallback; // file contents when mmap is not available
+};
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef FILEWATCHER_HPP
+#define FILEWATCHER_HPP
+#include "FileUtil.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <chrono>
+using namespace std;
+
+// Tells the app when data files in one folder change, so it reloads only then.
+// On Linux this is an inotify watch on the folder (catches appends, rewrites,
+// and files replaced by rename). Elsewhere, or if inotify is unavailable, it
+// falls back to comparing FileStamps every pollInterval.
+class FileWatcher
+{
+public:
+    explicit FileWatcher(const string &folder, chrono::milliseconds pollInterval = chrono::milliseconds(500));
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher &) = delete;
+    FileWatcher &operator=(const FileWatcher &) = delete;
+
+    void watch(const string &name); // file name inside the folder; need not exist yet
+
+    // Non-blocking: collects changes since the last call. True if any are pending.
+    bool check();
+    // Names of the watched files that changed, and forgets them
+    vector<string> take();
+
+    bool usingInotify() const { return fd >= 0; }
+
+private:
+    string folder;
+    int fd = -1;                 // inotify descriptor, -1 when polling
+    map<string, FileStamp> files; // watched names (stamps only used when polling)
+    set<string> pending;
+    chrono::milliseconds pollInterval;
+    chrono::steady_clock::time_point lastPoll;
+
+    void readEvents();
+    void pollStamps();
+};
+
+#endif
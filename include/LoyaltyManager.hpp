@@ -1,14 +1,27 @@
-#ifndef LOYALTYMANAGER_HPP
-#define LOYALTYMANAGER_HPP
-
-#include "Customer.hpp"
-#include "Order.hpp"
-#include <vector>
-
-class LoyaltyManager {
-public:
-    static bool isEligibleForDiscount(const Customer &c);
-    static void processCheckout(Customer &c, std::vector<Order> &orders, bool useDiscount); 
-};
-
-#endif
\ No newline at end of file
+#ifndef LOYALTYMANAGER_HPP
+#define LOYALTYMANAGER_HPP
+
+#include "Customer.hpp"
+#include "Order.hpp"
+#include <vector>
+
+// One cart of a batch checkout
+struct BatchCart {
+    Customer *customer = nullptr;
+    bool useDiscount = false;
+};
+
+class LoyaltyManager {
+public:
+    static bool isEligibleForDiscount(const Customer &c);
+    // False if the orders could not be saved; the customer is then not charged
+    // (spent points are given back and no reward is journaled).
+    static bool processCheckout(Customer &c, std::vector<Order> &orders, bool useDiscount);
+    // Checks out many carts at once (lunch rush, bulk imports): one id block for all
+    // carts, then every order and every points change go out in one append each.
+    // Returns the placed orders, grouped by restaurant; empty if the append failed
+    // (then, as above, nobody is charged).
+    static std::vector<Order> processBatchCheckout(const std::vector<BatchCart> &carts);
+};
+
+#endif
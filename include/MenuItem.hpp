@@ -1,14 +1,16 @@
-#ifndef MENUITEM_HPP
-#define MENUITEM_HPP
-#include <string>
-using namespace std;
-
-struct MenuItem
-{
-    int id = 0;
-    string name;
-    double price = 0.0;
-    bool available = true;
-};
-
+#ifndef MENUITEM_HPP
+#define MENUITEM_HPP
+#include "Money.hpp"
+#include "Symbol.hpp"
+#include <string>
+using namespace std;
+
+struct MenuItem
+{
+    int id = 0;
+    Symbol name; // interned, see Symbol.hpp
+    Money price;
+    bool available = true;
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,87 @@
+#ifndef METRICS_HPP
+#define METRICS_HPP
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Operational counters, gauges and histograms for production monitoring,
+// exported in Prometheus' text exposition format (Metrics::prometheusText,
+// Metrics::writeFile, or over HTTP with MetricsServer).
+//
+// Updates are relaxed atomic adds. A Counter is split into a few cache-line
+// sized shards and every thread adds to its own, so terminals and the
+// PersistenceService thread never bounce one line between cores; reads sum
+// the shards. Look a metric up once and keep the reference on hot paths:
+// the lookup itself takes the registry's (shared) lock.
+
+class Counter
+{
+public:
+    void add(uint64_t n = 1) { shards[shardIndex()].n.fetch_add(n, memory_order_relaxed); }
+    uint64_t value() const;
+
+private:
+    static const int SHARDS = 8;
+    struct alignas(64) Shard { atomic<uint64_t> n{0}; };
+    Shard shards[SHARDS];
+    static int shardIndex(); // fixed per thread
+};
+
+class Gauge
+{
+public:
+    void set(int64_t v) { n.store(v, memory_order_relaxed); }
+    void add(int64_t d) { n.fetch_add(d, memory_order_relaxed); }
+    int64_t value() const { return n.load(memory_order_relaxed); }
+
+private:
+    atomic<int64_t> n{0};
+};
+
+// Durations in fixed buckets, exported in seconds
+class Histogram
+{
+public:
+    explicit Histogram(const vector<double> &boundsSeconds);
+    void observeNs(uint64_t ns); // two relaxed adds
+
+    const vector<double> &bounds() const { return boundsSec; }
+    vector<uint64_t> bucketCounts() const; // per bucket (not cumulative), the last one is +Inf
+    uint64_t sumNs() const { return sum.value(); }
+
+private:
+    vector<double> boundsSec;
+    vector<uint64_t> boundsNs;
+    vector<Counter> buckets;
+    Counter sum;
+};
+
+struct Metrics
+{
+    // Default histogram buckets: 100 us .. 10 s
+    static const vector<double> &latencyBuckets();
+
+    // Registers the metric on first use and returns the same one afterwards.
+    // name: Prometheus metric name; labels: preformatted, e.g. restaurant="3" (or "")
+    static Counter &counter(const string &name, const string &help, const string &labels = "");
+    static Gauge &gauge(const string &name, const string &help, const string &labels = "");
+    static Histogram &histogram(const string &name, const string &help, const string &labels = "",
+                                const vector<double> &boundsSeconds = latencyBuckets());
+
+    // Label value with \, " and newline escaped
+    static string label(const string &key, const string &value);
+    static string label(const string &key, long long value) { return label(key, to_string(value)); }
+
+    // Runs before every export, for gauges that are cheaper to read on demand (file sizes)
+    static void addCollector(function<void()> collect);
+
+    static string prometheusText();
+    // Writes the text to path + ".tmp" and renames it over path, so a scraper
+    // (e.g. node_exporter's textfile collector) never reads half a file
+    static bool writeFile(const string &path);
+};
+
+#endif
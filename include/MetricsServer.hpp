@@ -0,0 +1,37 @@
+#ifndef METRICSSERVER_HPP
+#define METRICSSERVER_HPP
+#include <atomic>
+#include <string>
+#include <thread>
+using namespace std;
+
+// Minimal HTTP listener for Prometheus scrapes: answers GET /metrics on
+// 127.0.0.1:<port> with Metrics::prometheusText(), one request at a time on
+// its own thread. Only bound to localhost; put a reverse proxy or an agent in
+// front of it to scrape from another machine. Not available on Windows
+// (start() returns false), use Metrics::writeFile there.
+class MetricsServer
+{
+public:
+    MetricsServer() = default;
+    ~MetricsServer(); // stops the listener
+
+    MetricsServer(const MetricsServer &) = delete;
+    MetricsServer &operator=(const MetricsServer &) = delete;
+
+    // port 0 picks a free one (see port()); false, with a message on stderr, if it cannot listen
+    bool start(int port);
+    void stop();
+    int port() const { return boundPort; }
+
+private:
+    int fd = -1;
+    int boundPort = 0;
+    atomic<bool> stopping{false};
+    thread worker;
+
+    void run();
+    void serveClient(int client);
+};
+
+#endif
@@ -0,0 +1,47 @@
+#ifndef MONEY_HPP
+#define MONEY_HPP
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <ostream>
+using namespace std;
+
+// An amount in paisa (1/100 PKR) held in a 64-bit integer, so sums and
+// discounts are exact and the binary formats can store it as a plain int64.
+// Text form is rupees: "120", "607.5", "19.99" (no locale, no trailing zeros).
+class Money
+{
+public:
+    constexpr Money() = default;
+    static constexpr Money fromPaisa(int64_t p) { return Money(p); }
+    static constexpr Money fromRupees(int64_t r) { return Money(r * 100); }
+
+    constexpr int64_t paisa() const { return p; }
+
+    // pct percent of the amount, rounded half away from zero (percent(90) = 10% off)
+    Money percent(int64_t pct) const;
+
+    // Parses the text form; false on anything else. More than two decimals are rounded.
+    static bool parse(string_view text, Money &out);
+    string str() const;
+
+    constexpr Money operator+(Money o) const { return Money(p + o.p); }
+    constexpr Money operator-(Money o) const { return Money(p - o.p); }
+    constexpr Money operator*(int64_t n) const { return Money(p * n); }
+    Money &operator+=(Money o) { p += o.p; return *this; }
+    Money &operator-=(Money o) { p -= o.p; return *this; }
+    constexpr bool operator==(Money o) const { return p == o.p; }
+    constexpr bool operator!=(Money o) const { return p != o.p; }
+    constexpr bool operator<(Money o) const { return p < o.p; }
+    constexpr bool operator<=(Money o) const { return p <= o.p; }
+    constexpr bool operator>(Money o) const { return p > o.p; }
+    constexpr bool operator>=(Money o) const { return p >= o.p; }
+
+private:
+    explicit constexpr Money(int64_t p) : p(p) {}
+    int64_t p = 0;
+};
+
+inline ostream &operator<<(ostream &os, Money m) { return os << m.str(); }
+
+#endif
@@ -1,30 +1,68 @@
-#ifndef ORDER_HPP
-#define ORDER_HPP
-#include "MenuItem.hpp"
-#include <vector>
-#include <string>
-using namespace std;
-
-struct OrderItem
-{
-    MenuItem itemSnapshot;
-    int qty;
-    double unitPrice;
-    double subtotal() const { return unitPrice * qty; }
-};
-
-class Order
-{
-public:
-    int id = 0;
-    int customerId = -1;
-    int restaurantId = -1;
-    vector<OrderItem> items;
-    double total = 0.0;
-    string status = "Placed";
-    bool place();
-    bool dispatch();
-    bool cancel();
-};
-
-#endif
\ No newline at end of file
+#ifndef ORDER_HPP
+#define ORDER_HPP
+#include "MenuItem.hpp"
+#include <vector>
+#include <string>
+#include <string_view>
+#include <cstdint>
+using namespace std;
+
+struct OrderItem
+{
+    MenuItem itemSnapshot;
+    int qty;
+    Money unitPrice;
+    Money subtotal() const { return unitPrice * qty; }
+};
+
+// Order lifecycle. The numeric values are stored in orders.bin, so only append.
+//   Placed -> Accepted -> Preparing -> Dispatched -> Delivered -> Refunded
+//   Placed / Accepted -> Cancelled (Placed may also go straight to Dispatched)
+enum class OrderStatus : uint8_t
+{
+    Placed = 0,
+    Accepted = 1,
+    Preparing = 2,
+    Dispatched = 3,
+    Delivered = 4,
+    Cancelled = 5,
+    Refunded = 6,
+};
+const int ORDER_STATUS_COUNT = 7;
+
+const char *toString(OrderStatus s);
+// "Placed", "Dispatched", ... as written by Persistence; false for anything else
+bool parseOrderStatus(string_view text, OrderStatus &out);
+bool canTransition(OrderStatus from, OrderStatus to);
+
+class Order
+{
+public:
+    int id = 0;
+    int customerId = -1;
+    int restaurantId = -1;
+    vector<OrderItem> items;
+    Money total;
+    OrderStatus status = OrderStatus::Placed;
+    // Number of status changes since the order was placed. A status record in the
+    // log carries the version it produces, and replay only applies the one that is
+    // exactly one past the current version, so when two terminals change the same
+    // order at once the first record wins on every terminal (optimistic concurrency).
+    int version = 0;
+    bool place();
+    // Moves to the given status if the lifecycle allows it (and bumps version)
+    bool transitionTo(OrderStatus next);
+    bool accept() { return transitionTo(OrderStatus::Accepted); }
+    bool startPreparing() { return transitionTo(OrderStatus::Preparing); }
+    bool dispatch() { return transitionTo(OrderStatus::Dispatched); }
+    bool deliver() { return transitionTo(OrderStatus::Delivered); }
+    bool cancel() { return transitionTo(OrderStatus::Cancelled); }
+    bool refund() { return transitionTo(OrderStatus::Refunded); }
+
+    // One checkout shares its order id across every restaurant in the cart,
+    // so an order is identified by (id, restaurantId).
+    static uint64_t makeKey(int id, int restaurantId) { return ((uint64_t)(uint32_t)id << 32) | (uint32_t)restaurantId; }
+    uint64_t key() const { return makeKey(id, restaurantId); }
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef ORDERSNAPSHOT_HPP
+#define ORDERSNAPSHOT_HPP
+#include "Order.hpp"
+#include "FileUtil.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstdint>
+using namespace std;
+
+// Binary, columnar snapshot of the order table (orders.bin).
+//
+// Layout (native little-endian, every section 8-byte aligned):
+//   Header                         fixed 152 bytes, see below
+//   int32   id[orders]             one column per Order field
+//   int32   customerId[orders]
+//   int32   restaurantId[orders]
+//   uint8   status[orders]         OrderStatus value
+//   int64   total[orders]          Money, in paisa
+//   int32   version[orders]        Order::version
+//   uint32  itemStart[orders + 1]  items of order i are itemStart[i] .. itemStart[i+1]-1
+//   int32   itemMenuId[items]
+//   uint32  itemName[items]        index into the string table
+//   int32   itemQty[items]
+//   int64   itemUnitPrice[items]   Money, in paisa
+//   uint32  stringStart[strings + 1]
+//   char    stringData[]           interned names, not NUL terminated
+//
+// The file is read through a memory map: OrderSnapshotView hands out the
+// columns in place, nothing is parsed.
+struct OrderSnapshotHeader
+{
+    enum Section { Id, CustomerId, RestaurantId, Status, Total, Version, ItemStart,
+                   ItemMenuId, ItemName, ItemQty, ItemUnitPrice, StringStart, StringData, SectionCount };
+
+    char magic[4];          // "SEOS"
+    uint32_t version;
+    uint32_t byteOrder;     // 0x01020304 as written by the producer
+    uint32_t headerSize;
+    uint64_t orderCount;
+    uint64_t itemCount;
+    uint64_t stringCount;
+    uint64_t fileSize;
+    uint64_t sections[SectionCount]; // byte offset of each section
+};
+static_assert(sizeof(OrderSnapshotHeader) == 152, "OrderSnapshotHeader must stay 152 bytes");
+
+class OrderSnapshotView
+{
+public:
+    static const uint32_t VERSION = 1; // bump on every layout change
+
+    // Maps and validates the file; false (with a message on stderr) if it is
+    // missing, truncated, or from another version.
+    bool open(const string &path);
+
+    size_t size() const { return orders; }
+    int id(size_t i) const { return col<int32_t>(OrderSnapshotHeader::Id)[i]; }
+    int customerId(size_t i) const { return col<int32_t>(OrderSnapshotHeader::CustomerId)[i]; }
+    int restaurantId(size_t i) const { return col<int32_t>(OrderSnapshotHeader::RestaurantId)[i]; }
+    OrderStatus status(size_t i) const { return (OrderStatus)col<uint8_t>(OrderSnapshotHeader::Status)[i]; }
+    Money total(size_t i) const { return Money::fromPaisa(col<int64_t>(OrderSnapshotHeader::Total)[i]); }
+    int version(size_t i) const { return col<int32_t>(OrderSnapshotHeader::Version)[i]; }
+
+    // items of order i are [itemBegin(i), itemEnd(i))
+    size_t itemBegin(size_t i) const { return col<uint32_t>(OrderSnapshotHeader::ItemStart)[i]; }
+    size_t itemEnd(size_t i) const { return col<uint32_t>(OrderSnapshotHeader::ItemStart)[i + 1]; }
+    int itemMenuId(size_t j) const { return col<int32_t>(OrderSnapshotHeader::ItemMenuId)[j]; }
+    string_view itemName(size_t j) const { return str(col<uint32_t>(OrderSnapshotHeader::ItemName)[j]); }
+    int itemQty(size_t j) const { return col<int32_t>(OrderSnapshotHeader::ItemQty)[j]; }
+    Money itemUnitPrice(size_t j) const { return Money::fromPaisa(col<int64_t>(OrderSnapshotHeader::ItemUnitPrice)[j]); }
+
+    Order order(size_t i) const; // materialize one order
+
+private:
+    unique_ptr<MappedFile> file;
+    const OrderSnapshotHeader *header = nullptr;
+    size_t orders = 0;
+
+    template <typename T>
+    const T *col(int section) const { return reinterpret_cast<const T *>(file->view().data() + header->sections[section]); }
+    string_view str(uint32_t index) const;
+};
+
+struct OrderSnapshot
+{
+    static bool write(const string &path, const vector<Order> &orders);
+    static vector<Order> read(const string &path);
+};
+
+#endif
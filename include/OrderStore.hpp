@@ -0,0 +1,60 @@
+#ifndef ORDERSTORE_HPP
+#define ORDERSTORE_HPP
+#include "Order.hpp"
+#include "FileUtil.hpp"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+using namespace std;
+
+// Result of OrderStore::changeStatus
+enum class StatusChange { Applied, Conflict, NotFound, NotAllowed, WriteFailed };
+
+// In-memory copy of orders.txt that follows the order event log.
+// refresh() only parses records appended to orders.txt.log since the last call;
+// the whole table is reloaded only when the snapshot was rewritten (compaction)
+// or the log was truncated or replaced.
+class OrderStore
+{
+public:
+    explicit OrderStore(const string &filename = "orders.txt");
+
+    // Picks up changes on disk. Returns true if the orders changed.
+    bool refresh();
+    void reload();
+
+    vector<Order> &orders() { return list; }
+    const vector<Order> &orders() const { return list; }
+    Order *find(int id, int restaurantId);
+
+    // Optimistic status change, safe with several terminals on one data folder.
+    // expectedVersion is the Order::version the caller last saw. Catches up with
+    // the log, returns Conflict if the order moved on since, appends the status
+    // record, then replays the log again: if another terminal's record for the
+    // same version landed first, that one wins and the result is Conflict.
+    // Changes to different orders take no lock against each other.
+    StatusChange changeStatus(int id, int restaurantId, OrderStatus next, int expectedVersion);
+
+    // Secondary indexes: positions in orders(), in file order
+    const vector<size_t> &ordersForCustomer(int customerId) const;
+    const vector<size_t> &ordersForRestaurant(int restaurantId) const;
+
+    // Bumped whenever the orders change, so views can cache what they build from them
+    unsigned long long generation() const { return gen; }
+
+private:
+    string filename;
+    vector<Order> list;
+    unordered_map<uint64_t, size_t> byKey; // Order::key() -> index in list
+    unordered_map<int, vector<size_t>> byCustomer;
+    unordered_map<int, vector<size_t>> byRestaurant;
+    FileStamp snapshotStamp;
+    FileStamp logStamp;
+    uintmax_t logOffset = 0; // bytes of the log already applied
+    unsigned long long gen = 0;
+
+    void indexFrom(size_t first); // adds list[first..] to the secondary indexes
+};
+
+#endif
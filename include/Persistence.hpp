@@ -1,44 +1,122 @@
-#ifndef PERSISTENCE_HPP
-#define PERSISTENCE_HPP
-
-#include "User.hpp"
-#include "Customer.hpp"
-#include "Owner.hpp"
-#include "Restaurant.hpp"
-#include "Order.hpp"
-#include <string>
-#include <vector>
-
-using namespace std;
-
-struct Persistence {
-    static string dataFolder; 
-    static void ensureDataFolderExists();
-    static int getNextId(const string &filename);
-
-    // --- NEW: Admin Verification ---
-    static bool verifyAdmin(int id, const string &password, const string &filename = "admin.txt");
-
-    // Customers
-    static void saveCustomer(const Customer &c, const string &filename = "customers.txt");
-    static vector<Customer> loadAllCustomers(const string &filename = "customers.txt");
-    static void saveAllCustomers(const vector<Customer> &customers, const string &filename = "customers.txt");
-
-    // Owners
-    static void saveOwner(const Owner &o, const string &filename = "owners.txt");
-    static vector<Owner> loadAllOwners(const string &filename = "owners.txt");
-    // --- NEW: Needed to save ban status ---
-    static void saveAllOwners(const vector<Owner> &owners, const string &filename = "owners.txt");
-
-    // Restaurants
-    static void saveRestaurant(const Restaurant &r, const string &filename = "restaurants.txt");
-    static vector<Restaurant> loadAllRestaurants(const string &filename = "restaurants.txt");
-    static void saveAllRestaurants(const vector<Restaurant> &restaurants, const string &filename = "restaurants.txt");
-
-    // Orders
-    static void saveOrder(const Order &o, const string &filename = "orders.txt");
-    static vector<Order> loadAllOrders(const string &filename = "orders.txt");
-    static void saveAllOrders(const vector<Order> &orders, const string &filename = "orders.txt");
-};
-
+#ifndef PERSISTENCE_HPP
+#define PERSISTENCE_HPP
+
+#include "User.hpp"
+#include "Customer.hpp"
+#include "Owner.hpp"
+#include "Restaurant.hpp"
+#include "Order.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <utility>
+
+using namespace std;
+
+// Result of Persistence::checkDataFile
+enum class DataFileCheck { Ok, NoChecksum, Missing, Corrupt };
+
+struct Persistence {
+    static string dataFolder; 
+    static void ensureDataFolderExists();
+
+    // Crash safety for the tables that are rewritten as a whole (saveAll*, compaction).
+    // The new file is built in memory, ends with a "#crc32=<hex> len=<bytes>" footer
+    // over everything before it, and replaces the old one atomically
+    // (FileUtil::replaceDurable), which stays behind as <file>.bak. Loaders skip
+    // '#' lines. Rows appended later (saveCustomer, ...) follow the footer and are
+    // not covered by it.
+    static string checksumFooter(uint32_t crc, uint64_t length); // with the "\n"
+    // NoChecksum: a file from before checksums (or written by hand), taken as is.
+    // Corrupt: the footer does not match, the file is empty (saveAll* never writes
+    // an empty file), or it has no footer but its .bak has one (a truncated file).
+    static DataFileCheck checkDataFile(const string &filename);
+    // Startup: a table that fails checkDataFile is moved to <file>.corrupt and
+    // restored from <file>.bak if that one checks out; otherwise it is left missing
+    // (and the caller can seed it again). One message per table it touched.
+    static vector<string> recoverDataFiles();
+    static int getNextId(const string &filename); // scans the whole file, prefer allocateId
+
+    // Reserves count consecutive ids for the table in filename and returns the first.
+    // The next free id lives in <filename>.seq and is bumped under a file lock, so this
+    // is O(1) and safe with several terminals checking out at once. The sequence is
+    // seeded from getNextId the first time (or if the .seq file is unreadable).
+    static int allocateId(const string &filename, int count = 1);
+
+    // --- NEW: Admin Verification ---
+    static bool verifyAdmin(int id, const string &password, const string &filename = "admin.txt");
+
+    // Customers
+    // Loyalty points are journaled: addLoyaltyPoints appends "id|delta" to
+    // customers.txt.points and loadAllCustomers adds the deltas on top of customers.txt.
+    // saveAllCustomers folds the journal back in. The snapshot's first line records
+    // which journal generation and how many of its bytes it already holds
+    // ("#points gen=G bytes=N"), and the folded journal is replaced by an empty one of
+    // generation G+1. A crash between the two steps leaves the old journal next to the
+    // new snapshot; replay then skips the N bytes instead of counting them twice.
+    // Journal access is serialized by customers.txt.points.lock (shared for appends,
+    // exclusive for folding and spending).
+    static void saveCustomer(const Customer &c, const string &filename = "customers.txt");
+    static vector<Customer> loadAllCustomers(const string &filename = "customers.txt");
+    // Rewrites names, contact details and bans. Points come from disk for every customer
+    // already there: a points value changed in memory is ignored, so a stale copy can
+    // never undo a checkout. Change points with addLoyaltyPoints / spendLoyaltyPoints.
+    static void saveAllCustomers(const vector<Customer> &customers, const string &filename = "customers.txt");
+    static string pointsJournalName(const string &filename);
+    static string pointsLockName(const string &filename);
+    static void addLoyaltyPoints(int customerId, int delta, const string &filename = "customers.txt"); // O(1), safe across terminals
+    static void addLoyaltyPoints(const vector<pair<int, int>> &deltas, const string &filename = "customers.txt"); // (id, delta) pairs, one append
+    // Spends cost points of each customer in ids where the balance on disk (snapshot +
+    // journal) covers it. The check and the -cost records happen under the journal's
+    // exclusive lock, so two terminals (or threads) can never spend the same points.
+    // Returns, per id, whether the points were spent; an id listed twice pays twice.
+    static vector<bool> spendLoyaltyPoints(const vector<int> &customerIds, int cost, const string &filename = "customers.txt");
+
+    // Owners
+    static void saveOwner(const Owner &o, const string &filename = "owners.txt");
+    static vector<Owner> loadAllOwners(const string &filename = "owners.txt");
+    // --- NEW: Needed to save ban status ---
+    static void saveAllOwners(const vector<Owner> &owners, const string &filename = "owners.txt");
+
+    // Restaurants
+    static void saveRestaurant(const Restaurant &r, const string &filename = "restaurants.txt");
+    static vector<Restaurant> loadAllRestaurants(const string &filename = "restaurants.txt");
+    static void saveAllRestaurants(const vector<Restaurant> &restaurants, const string &filename = "restaurants.txt");
+
+    // Orders
+    // orders.txt is a snapshot. New orders and status changes are appended to an
+    // event log (orders.txt.log) and folded back into the snapshot by compactOrders(),
+    // which runs automatically once the log grows past orderLogCompactBytes.
+    static size_t orderLogCompactBytes;
+    static string orderLogName(const string &filename);
+    static string orderLockName(const string &filename); // flock: shared for appends, exclusive for compaction
+    // The save* appends return false if the record could not be written (message on stderr)
+    static bool saveOrder(const Order &o, const string &filename = "orders.txt"); // appends a place record
+    static bool saveOrders(const vector<Order> &orders, const string &filename = "orders.txt"); // all place records in one write + fsync
+    static bool saveOrderStatus(const Order &o, const string &filename = "orders.txt"); // appends a status record
+    // The status record alone: carries o.version, never compacts; false if the append failed.
+    // OrderStore::changeStatus builds the optimistic check on top of this.
+    static bool appendOrderStatus(const Order &o, const string &filename = "orders.txt");
+    static vector<Order> loadAllOrders(const string &filename = "orders.txt"); // snapshot + log replay
+    static void saveAllOrders(const vector<Order> &orders, const string &filename = "orders.txt"); // rewrites snapshot, clears log
+    // Like saveAllOrders, but first replays the current log onto orders, under the same
+    // lock: for a snapshot taken earlier (e.g. orders.bin back to text), so nothing
+    // logged since the last compaction is lost.
+    static void restoreOrders(vector<Order> orders, const string &filename = "orders.txt");
+    static string formatOrder(const Order &o); // one orders.txt line, without the newline
+    static void compactOrders(const string &filename = "orders.txt");
+    static void compactOrdersIfDue(const string &filename = "orders.txt"); // once the log reaches orderLogCompactBytes
+    // Binary columnar snapshot (see OrderSnapshot.hpp). compactOrders keeps an existing
+    // orders.bin in step with orders.txt.
+    static bool saveOrdersBinary(const vector<Order> &orders, const string &filename = "orders.bin");
+    static vector<Order> loadOrdersBinary(const string &filename = "orders.bin");
+    // Building blocks for readers that follow the log incrementally (OrderStore)
+    static vector<Order> loadOrderSnapshot(const string &filename = "orders.txt");
+    // Applies the complete records in chunk; byKey maps Order::key() to an index in orders.
+    // Returns the number of bytes consumed (a torn record at the end is left for later).
+    static size_t applyOrderLog(string_view chunk, vector<Order> &orders, unordered_map<uint64_t, size_t> &byKey);
+};
+
 #endif
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef PERSISTENCESERVICE_HPP
+#define PERSISTENCESERVICE_HPP
+#include <string>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+using namespace std;
+
+// Runs Persistence calls on a background thread so the window never waits
+// for a file rewrite. Jobs run one at a time in submission order.
+//
+// Coalescing: a job submitted with a non-empty key replaces a job with the same
+// key that is still waiting in the queue (e.g. two saveAllOwners before the
+// first one started): only the newest snapshot is written, and the futures of
+// both callers complete when it is. Appends (saveOrder, saveOrderStatus, ...)
+// must use an empty key so every record is written.
+//
+// Jobs should capture what they write by value; the caller keeps editing its
+// own copy while the job runs.
+class PersistenceService
+{
+public:
+    PersistenceService();
+    ~PersistenceService(); // finishes every queued job before returning
+
+    PersistenceService(const PersistenceService &) = delete;
+    PersistenceService &operator=(const PersistenceService &) = delete;
+
+    future<void> submit(const string &key, function<void()> job);
+    void flush(); // blocks until the queue is empty and nothing is running
+    bool idle();
+
+private:
+    struct Task
+    {
+        string key;
+        function<void()> job;
+        vector<promise<void>> waiters;
+    };
+
+    deque<Task> queue;
+    mutex m;
+    condition_variable wake, drained;
+    bool running = false;
+    bool stopping = false;
+    thread worker;
+
+    void run();
+};
+
+#endif
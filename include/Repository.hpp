@@ -0,0 +1,56 @@
+#ifndef REPOSITORY_HPP
+#define REPOSITORY_HPP
+#include "Customer.hpp"
+#include "Owner.hpp"
+#include "Restaurant.hpp"
+#include "OrderStore.hpp"
+#include <vector>
+#include <unordered_map>
+using namespace std;
+
+// In-memory tables loaded from Persistence, with hash indexes so lookups cost
+// O(matching rows) instead of a scan over every row.
+//   primary:   customer / owner / restaurant by id (orders: OrderStore::find)
+//   secondary: restaurants by ownerId, orders by customerId / restaurantId
+// The set* functions replace a table and rebuild its indexes. Editing rows in
+// place is fine as long as the indexed ids (id, ownerId) do not change.
+//
+// The rows are the only copy: a logged-in session keeps the customer id and
+// looks the row up (pointers go stale when a table is replaced). Carts are not
+// saved, so setCustomers moves each customer's cart over to the reloaded row.
+class Repository
+{
+public:
+    Repository() = default;
+
+    void setCustomers(vector<Customer> rows);
+    void setOwners(vector<Owner> rows);
+    void setRestaurants(vector<Restaurant> rows);
+
+    vector<Customer> &customers() { return customerRows; }
+    vector<Owner> &owners() { return ownerRows; }
+    vector<Restaurant> &restaurants() { return restaurantRows; }
+    OrderStore &orders() { return orderStore; }
+
+    Customer *findCustomer(int id);
+    Owner *findOwner(int id);
+    Restaurant *findRestaurant(int id);
+
+    // positions in restaurants()
+    const vector<size_t> &restaurantsOf(int ownerId) const;
+    // positions in orders().orders() for every restaurant of the owner, in file order
+    vector<size_t> ordersForOwner(int ownerId) const;
+
+private:
+    vector<Customer> customerRows;
+    vector<Owner> ownerRows;
+    vector<Restaurant> restaurantRows;
+    OrderStore orderStore;
+
+    unordered_map<int, size_t> customerById;
+    unordered_map<int, size_t> ownerById;
+    unordered_map<int, size_t> restaurantById;
+    unordered_map<int, vector<size_t>> restaurantsByOwner;
+};
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef SESSION_HPP
+#define SESSION_HPP
+#include "Repository.hpp"
+#include <string>
+using namespace std;
+
+enum class Role { Guest, CustomerRole, OwnerRole, AdminRole };
+
+// Result of Session::loginCustomer / loginOwner
+enum class LoginResult { Ok, BadCredentials, Disabled };
+
+// Who is logged in on this terminal. The session keeps ids only: the customer
+// (and their cart) is the row in the Repository and is looked up again when
+// needed, so logging in copies nothing and a table reload never leaves the
+// session holding a stale copy.
+struct Session
+{
+    Role role = Role::Guest;
+    int userId = -1;
+    int ownerId = -1;
+
+    // On Ok the session switches to that user; otherwise it is left as it was
+    LoginResult loginCustomer(Repository &repo, int id, const string &password);
+    LoginResult loginOwner(Repository &repo, int id, const string &password);
+    bool loginAdmin(int id, const string &password); // checked against admin.txt
+
+    // The logged-in customer's row, null for any other role
+    Customer *customer(Repository &repo) const;
+    // Back to Guest; the cart belongs to the session, so a customer's is emptied
+    void logout(Repository &repo);
+};
+
+#endif
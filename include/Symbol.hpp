@@ -0,0 +1,53 @@
+#ifndef SYMBOL_HPP
+#define SYMBOL_HPP
+#include <string>
+#include <string_view>
+#include <ostream>
+#include <functional>
+#include <cstdint>
+using namespace std;
+
+// A name interned in one process-wide table and stored as a 4-byte id.
+// Menu item and restaurant names repeat in every cart line and order item, so
+// each distinct name is kept once and copies of it are just the id.
+// Equal names always get the same id; comparing two symbols compares ids.
+// Interning and str() are thread-safe; entries are never removed, so the
+// reference from str() stays valid for the life of the process.
+class Symbol
+{
+public:
+    Symbol() = default; // the empty name
+    Symbol(string_view s) : sym(intern(s)) {}
+    Symbol(const string &s) : sym(intern(s)) {}
+    Symbol(const char *s) : sym(intern(s)) {}
+
+    const string &str() const;
+    uint32_t id() const { return sym; }
+    bool empty() const { return sym == 0; }
+
+    bool operator==(Symbol o) const { return sym == o.sym; }
+    bool operator!=(Symbol o) const { return sym != o.sym; }
+
+    static size_t tableSize(); // distinct names interned so far, including ""
+
+private:
+    static uint32_t intern(string_view s);
+    uint32_t sym = 0;
+};
+
+inline ostream &operator<<(ostream &os, Symbol s) { return os << s.str(); }
+inline string operator+(const string &a, Symbol b) { return a + b.str(); }
+inline string operator+(const char *a, Symbol b) { return a + b.str(); }
+inline string operator+(Symbol a, const string &b) { return a.str() + b; }
+inline string operator+(Symbol a, const char *b) { return a.str() + b; }
+
+namespace std
+{
+template <>
+struct hash<Symbol>
+{
+    size_t operator()(Symbol s) const { return hash<uint32_t>()(s.id()); }
+};
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef THEME_HPP
+#define THEME_HPP
+#include <SFML/Graphics.hpp>
+
+// --- THEME COLORS ---
+const sf::Color COL_BG(30, 32, 36);          
+const sf::Color COL_PANEL(40, 44, 52);       
+const sf::Color COL_HEADER(230, 81, 0);      
+const sf::Color COL_TEXT_MAIN(236, 240, 241);
+const sf::Color COL_TEXT_SEC(149, 165, 166);
+const sf::Color COL_ACCENT(241, 196, 15);    
+const sf::Color COL_CARD(50, 55, 65);        
+const sf::Color COL_BTN_GREEN(39, 174, 96);
+const sf::Color COL_BTN_RED(192, 57, 43);
+const sf::Color COL_BTN_HOVER(255, 255, 255, 50); 
+
+#endif
@@ -0,0 +1,70 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+#include <string>
+#include <vector>
+#include <cstdint>
+using namespace std;
+
+// Hot-path instrumentation.
+//   SE_TRACE_SCOPE("name")            times the rest of the enclosing block
+//   SE_TRACE_COUNTER("name", value)   records a counter sample (rows loaded, bytes appended, ...)
+// Configure with -DSUSTIEATS_TRACE=OFF and both expand to nothing.
+//
+// Every scope adds to a per-name total that the GUI overlay reads once a frame
+// (takeStats). While a capture runs, scopes and counters are also kept as events,
+// and writeChromeTrace exports them for chrome://tracing or Perfetto.
+// Names must be string literals (only the pointer is stored).
+// Each thread records into its own buffer; the cost of a scope is two clock
+// reads and an uncontended lock.
+
+struct TraceStat
+{
+    string name;
+    uint64_t calls = 0;   // scopes ended, or counter samples
+    uint64_t totalNs = 0; // scopes only
+    uint64_t maxNs = 0;
+    int64_t value = 0;    // counters: sum of the samples
+};
+
+struct Trace
+{
+    static uint64_t nowNs(); // since the first use of Trace in this process
+
+    static void scopeEnded(const char *name, uint64_t startNs, uint64_t endNs);
+    static void counter(const char *name, int64_t value);
+    static void nameThread(const string &name); // label for this thread in exported traces
+
+    static void startCapture(); // drops events from an earlier capture
+    static void stopCapture();
+    static bool capturing();
+    // Events of the current or last capture; false (with a message on stderr) if the file cannot be written
+    static bool writeChromeTrace(const string &path);
+
+    // Per-name totals of every thread since the last call, slowest first
+    static vector<TraceStat> takeStats();
+};
+
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name) : name(name), start(Trace::nowNs()) {}
+    ~TraceScope() { Trace::scopeEnded(name, start, Trace::nowNs()); }
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+    uint64_t start;
+};
+
+#if SUSTIEATS_TRACE
+#define SE_TRACE_CAT2(a, b) a##b
+#define SE_TRACE_CAT(a, b) SE_TRACE_CAT2(a, b)
+#define SE_TRACE_SCOPE(name) TraceScope SE_TRACE_CAT(traceScope_, __LINE__)(name)
+#define SE_TRACE_COUNTER(name, value) Trace::counter(name, (int64_t)(value))
+#else
+#define SE_TRACE_SCOPE(name) ((void)0)
+#define SE_TRACE_COUNTER(name, value) ((void)0)
+#endif
+
+#endif
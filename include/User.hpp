@@ -1,23 +1,28 @@
-#ifndef USER_HPP
-#define USER_HPP
-#include <string>
-using namespace std;
-
-class User
-{
-public:
-    int id = 0;
-    string name;
-    string phone;
-    string email;
-    string password;
-    bool isActive = true;
-    User() = default;
-    User(int id_, const string &n) : id(id_), name(n) {}
-    virtual bool login(const string &pw) { return pw == password; }
-    virtual void logout() {}
-    virtual void displayDashboard() {}
-    virtual ~User() = default;
-};
-
+#ifndef USER_HPP
+#define USER_HPP
+#include <string>
+using namespace std;
+
+class User
+{
+public:
+    int id = 0;
+    string name;
+    string phone;
+    string email;
+    string password;
+    bool isActive = true;
+    User() = default;
+    User(int id_, const string &n) : id(id_), name(n) {}
+    // Declared because the virtual destructor would otherwise turn every move into a copy
+    User(const User &) = default;
+    User(User &&) = default;
+    User &operator=(const User &) = default;
+    User &operator=(User &&) = default;
+    virtual bool login(const string &pw) { return pw == password; }
+    virtual void logout() {}
+    virtual void displayDashboard() {}
+    virtual ~User() = default;
+};
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,29 @@
+#ifndef VIRTUALLIST_HPP
+#define VIRTUALLIST_HPP
+#include <vector>
+#include <utility>
+#include <cstddef>
+using namespace std;
+
+// Row layout for a long scrolling list. Heights are added once, when the list
+// changes; the running offsets then let a view find the rows inside its
+// window with a binary search, so only those get laid out and drawn.
+class VirtualList
+{
+public:
+    void clear() { offsets.assign(1, 0.f); }
+    void push(float height) { offsets.push_back(offsets.back() + height); } // height includes the gap below
+
+    size_t size() const { return offsets.size() - 1; }
+    float top(size_t i) const { return offsets[i]; }
+    float height(size_t i) const { return offsets[i + 1] - offsets[i]; }
+    float totalHeight() const { return offsets.back(); }
+
+    // Rows [first, last) that overlap the band [y0, y1)
+    pair<size_t, size_t> visible(float y0, float y1) const;
+
+private:
+    vector<float> offsets{0.f}; // offsets[i] = top of row i, offsets[size()] = total height
+};
+
+#endif
@@ -1,5 +1,5 @@
-#include "Admin.hpp"
-#include <iostream>
-using namespace std;
-
+#include "Admin.hpp"
+#include <iostream>
+using namespace std;
+
 void Admin::disableUser(int userId) { cout << "Admin::disableUser(" << userId << ")\n"; }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "CardCache.hpp"
+#include "Theme.hpp"
+#include <string>
+
+// Two triangles per rectangle, so a whole card is a single draw call
+static void addRect(sf::VertexArray &va, const sf::FloatRect &r, const sf::Color &c) {
+    sf::Vector2f a(r.left, r.top), b(r.left + r.width, r.top);
+    sf::Vector2f d(r.left, r.top + r.height), e(r.left + r.width, r.top + r.height);
+    va.append(sf::Vertex(a, c)); va.append(sf::Vertex(b, c)); va.append(sf::Vertex(e, c));
+    va.append(sf::Vertex(a, c)); va.append(sf::Vertex(e, c)); va.append(sf::Vertex(d, c));
+}
+
+static sf::Color statusColor(OrderStatus s) {
+    if (s == OrderStatus::Dispatched || s == OrderStatus::Delivered) return COL_BTN_GREEN;
+    if (s == OrderStatus::Cancelled || s == OrderStatus::Refunded) return COL_BTN_RED;
+    return sf::Color::Yellow;
+}
+
+// ---------- OrderCard ----------
+
+void OrderCard::build(const Order &o, const sf::Font &font) {
+    builtStatus = o.status;
+    cardHeight = 130.f + (o.items.size() * 20.f);
+    buttons = (o.status == OrderStatus::Placed);
+
+    shapes.clear();
+    shapes.setPrimitiveType(sf::Triangles);
+    addRect(shapes, sf::FloatRect(19.f, -1.f, 622.f, cardHeight + 2.f), sf::Color(70, 70, 70)); // outline
+    addRect(shapes, sf::FloatRect(20.f, 0.f, 620.f, cardHeight), COL_CARD);
+
+    // "Order #12  [Placed]  Total: 900", status in its own colour
+    info = sf::Text("Order #" + std::to_string(o.id) + "  ", font, 18);
+    info.setPosition(35.f, 15.f);
+    info.setFillColor(COL_ACCENT);
+    status = sf::Text(std::string("[") + toString(o.status) + "]", font, 18);
+    status.setPosition(info.findCharacterPos(info.getString().getSize()));
+    status.setFillColor(statusColor(o.status));
+    total = sf::Text("  Total: " + o.total.str(), font, 18);
+    total.setPosition(status.findCharacterPos(status.getString().getSize()));
+    total.setFillColor(COL_ACCENT);
+
+    std::string itemsStr;
+    for (const auto &it : o.items) itemsStr += "- " + it.itemSnapshot.name + " x" + std::to_string(it.qty) + "\n";
+    items = sf::Text(itemsStr, font, 16);
+    items.setPosition(35.f, 45.f);
+    items.setFillColor(sf::Color::White);
+
+    if (buttons) {
+        float btnY = cardHeight - 40.f; // Bottom of card
+        float btnX = 35.f;
+        dispatchRect = sf::FloatRect(btnX, btnY, 100.f, 30.f);
+        cancelRect = sf::FloatRect(btnX + 120.f, btnY, 100.f, 30.f);
+        addRect(shapes, dispatchRect, COL_BTN_GREEN);
+        addRect(shapes, cancelRect, COL_BTN_RED);
+        dispatchLabel = sf::Text("Dispatch", font, 14); dispatchLabel.setPosition(btnX + 15, btnY + 5);
+        cancelLabel = sf::Text("Cancel", font, 14); cancelLabel.setPosition(btnX + 120.f + 25, btnY + 5);
+    }
+}
+
+void OrderCard::draw(sf::RenderTarget &target, sf::RenderStates states) const {
+    target.draw(shapes, states);
+    target.draw(info, states);
+    target.draw(status, states);
+    target.draw(total, states);
+    target.draw(items, states);
+    if (buttons) {
+        target.draw(dispatchLabel, states);
+        target.draw(cancelLabel, states);
+    }
+}
+
+const OrderCard &OrderCardCache::get(const Order &o) {
+    auto res = cards.try_emplace(o.key());
+    Entry &e = res.first->second;
+    e.used = true;
+    // Items and total never change once placed, so the status is the only thing to compare
+    if (res.second || e.card.builtStatus != o.status) e.card.build(o, font);
+    return e.card;
+}
+
+void OrderCardCache::evictUnused() {
+    for (auto it = cards.begin(); it != cards.end();) {
+        if (!it->second.used) {
+            it = cards.erase(it);
+        } else {
+            it->second.used = false;
+            ++it;
+        }
+    }
+}
+
+// ---------- UserRowCard ----------
+
+void UserRowCard::build(int id, const std::string &name, bool active, const sf::Font &font) {
+    builtName = name;
+    builtActive = active;
+
+    shapes.clear();
+    shapes.setPrimitiveType(sf::Triangles);
+    addRect(shapes, sf::FloatRect(20.f, 0.f, 600.f, 50.f), COL_CARD);
+    buttonRect = sf::FloatRect(480.f, 10.f, 120.f, 30.f);
+    addRect(shapes, buttonRect, active ? COL_BTN_RED : COL_BTN_GREEN);
+
+    info = sf::Text((active ? "[ACTIVE] " : "[BANNED] ") + name + " (ID: " + std::to_string(id) + ")", font, 18);
+    info.setPosition(30.f, 12.f);
+    info.setFillColor(active ? COL_BTN_GREEN : COL_BTN_RED);
+    label = sf::Text(active ? "Deactivate" : "Activate", font, 14);
+    label.setPosition(480.f + 15.f, 7.f);
+}
+
+void UserRowCard::draw(sf::RenderTarget &target, sf::RenderStates states) const {
+    target.draw(shapes, states);
+    target.draw(info, states);
+    target.draw(label, states);
+}
+
+const UserRowCard &UserRowCache::get(int id, const std::string &name, bool active, bool isOwner) {
+    uint64_t key = ((uint64_t)isOwner << 32) | (uint32_t)id;
+    auto res = rows.try_emplace(key);
+    UserRowCard &row = res.first->second;
+    if (res.second || row.builtActive != active || row.builtName != name) row.build(id, name, active, font);
+    return row;
+}
+
+void drawHoverOutline(sf::RenderTarget &target, const sf::FloatRect &rect, float yOffset) {
+    sf::RectangleShape hl(sf::Vector2f(rect.width, rect.height));
+    hl.setPosition(rect.left, rect.top + yOffset);
+    hl.setFillColor(sf::Color::Transparent);
+    hl.setOutlineThickness(2.f);
+    hl.setOutlineColor(sf::Color::White);
+    target.draw(hl);
+}
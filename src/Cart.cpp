@@ -1,35 +1,54 @@
-#include "Cart.hpp"
-#include <algorithm>
-using namespace std;
-
-void Cart::addItem(const MenuItem &mi, int qty, int restId, const string &restName)
-{
-    for (auto &ci : items)
-    {
-        if (ci.item.id == mi.id && ci.restaurantId == restId)
-        {
-            ci.qty += qty;
-            return;
-        }
-    }
-    // Create new item with restaurant info
-    CartItem ci{mi, qty, restId, restName};
-    items.push_back(ci);
-}
-
-void Cart::removeItem(int menuId)
-{
-    items.erase(remove_if(items.begin(), items.end(), [&](const CartItem &c)
-                          { return c.item.id == menuId; }),
-                items.end());
-}
-
-double Cart::getTotal() const
-{
-    double t = 0.0;
-    for (const auto &ci : items)
-        t += ci.subtotal();
-    return t;
-}
-
-void Cart::clear() { items.clear(); }
\ No newline at end of file
+#include "Cart.hpp"
+using namespace std;
+
+void Cart::addItem(const MenuItem &mi, int qty, int restId, Symbol restName)
+{
+    auto found = byKey.find(makeKey(restId, mi.id));
+    if (found != byKey.end())
+    {
+        // The whole line moves to the item as added now (its price may have changed),
+        // so the total stays the sum of the line subtotals
+        CartItem &line = lines[found->second];
+        total -= line.subtotal();
+        line.item = mi;
+        line.qty += qty;
+        total += line.subtotal();
+        return;
+    }
+    // Create new item with restaurant info
+    total += mi.price * qty;
+    byKey.emplace(makeKey(restId, mi.id), lines.size());
+    lines.push_back(CartItem{mi, qty, restId, restName});
+}
+
+void Cart::eraseAt(size_t i)
+{
+    const CartItem &ci = lines[i];
+    total -= ci.subtotal();
+    byKey.erase(makeKey(ci.restaurantId, ci.item.id));
+    if (i + 1 != lines.size())
+    {
+        lines[i] = move(lines.back());
+        byKey[makeKey(lines[i].restaurantId, lines[i].item.id)] = i;
+    }
+    lines.pop_back();
+}
+
+void Cart::removeItem(int restId, int menuId)
+{
+    auto found = byKey.find(makeKey(restId, menuId));
+    if (found != byKey.end()) eraseAt(found->second);
+}
+
+void Cart::removeItem(int menuId)
+{
+    for (size_t i = lines.size(); i-- > 0;)
+        if (lines[i].item.id == menuId) eraseAt(i);
+}
+
+void Cart::clear()
+{
+    lines.clear();
+    byKey.clear();
+    total = Money();
+}
@@ -0,0 +1,267 @@
+#include "FileUtil.hpp"
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/file.h>
+#endif
+
+using namespace std;
+
+bool FileUtil::appendDurable(const string &path, const string &data, bool sharedLock)
+{
+#ifdef _WIN32
+    (void)sharedLock;
+    int fd = _open(path.c_str(), _O_WRONLY | _O_APPEND | _O_CREAT | _O_BINARY, 0644);
+    if (fd < 0) return false;
+    bool ok = _write(fd, data.data(), (unsigned)data.size()) == (int)data.size();
+    ok = ok && _commit(fd) == 0;
+    _close(fd);
+    return ok;
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0) return false;
+    if (sharedLock && ::flock(fd, LOCK_SH) != 0) { ::close(fd); return false; }
+    // O_APPEND makes each write land at the current end of file, so records
+    // from other processes are never interleaved inside one of ours
+    size_t done = 0;
+    bool ok = true;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n <= 0) { ok = false; break; }
+        done += (size_t)n;
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd);
+    return ok;
+#endif
+}
+
+uintmax_t FileUtil::fileSize(const string &path)
+{
+    error_code ec;
+    uintmax_t sz = filesystem::file_size(path, ec);
+    return ec ? 0 : sz;
+}
+
+FileStamp FileUtil::stamp(const string &path)
+{
+    FileStamp st;
+#ifdef _WIN32
+    error_code ec;
+    st.size = filesystem::file_size(path, ec);
+    if (ec) return FileStamp();
+    st.exists = true;
+    st.mtimeNs = (long long)filesystem::last_write_time(path, ec).time_since_epoch().count();
+#else
+    struct stat sb;
+    if (::stat(path.c_str(), &sb) != 0) return st;
+    st.exists = true;
+    st.size = (uintmax_t)sb.st_size;
+    st.mtimeNs = (long long)sb.st_mtim.tv_sec * 1000000000LL + sb.st_mtim.tv_nsec;
+    st.inode = (unsigned long long)sb.st_ino;
+#endif
+    return st;
+}
+
+string FileUtil::readFrom(const string &path, uintmax_t offset)
+{
+    ifstream ifs(path, ios::binary);
+    if (!ifs) return "";
+    ifs.seekg(0, ios::end);
+    streamoff end = ifs.tellg();
+    if (end <= (streamoff)offset) return "";
+    string out((size_t)(end - (streamoff)offset), '\0');
+    ifs.seekg((streamoff)offset);
+    ifs.read(&out[0], (streamsize)out.size());
+    out.resize((size_t)ifs.gcount());
+    return out;
+}
+
+bool FileUtil::updateLocked(const string &path, const function<string(const string &)> &update)
+{
+#ifdef _WIN32
+    // No flock on Windows: single-terminal deployments only
+    ifstream ifs(path, ios::binary);
+    string current((istreambuf_iterator<char>(ifs)), istreambuf_iterator<char>());
+    ifs.close();
+    string next = update(current);
+    int fd = _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+    if (fd < 0) return false;
+    bool ok = _write(fd, next.data(), (unsigned)next.size()) == (int)next.size() && _commit(fd) == 0;
+    _close(fd);
+    return ok;
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return false;
+    if (::flock(fd, LOCK_EX) != 0) { ::close(fd); return false; }
+
+    string current;
+    char buf[4096];
+    ssize_t n;
+    while ((n = ::read(fd, buf, sizeof(buf))) > 0) current.append(buf, (size_t)n);
+
+    string next = update(current);
+    bool ok = ::ftruncate(fd, 0) == 0 && ::lseek(fd, 0, SEEK_SET) == 0;
+    size_t done = 0;
+    while (ok && done < next.size()) {
+        n = ::write(fd, next.data() + done, next.size() - done);
+        if (n <= 0) ok = false;
+        else done += (size_t)n;
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ::close(fd); // releases the lock
+    return ok;
+#endif
+}
+
+bool FileUtil::replaceDurable(const string &path, string_view data, bool keepBackup)
+{
+    // A temp name of our own next to path: two terminals saving the same table
+    // at once must not write into (or rename away) each other's temp file
+    string tmp = path + ".tmpXXXXXX";
+#ifdef _WIN32
+    if (_mktemp_s(&tmp[0], tmp.size() + 1) != 0) return false;
+    int fd = _open(tmp.c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY, _S_IREAD | _S_IWRITE);
+    if (fd < 0) return false;
+    bool ok = _write(fd, data.data(), (unsigned)data.size()) == (int)data.size() && _commit(fd) == 0;
+    _close(fd);
+#else
+    int fd = ::mkstemp(&tmp[0]);
+    if (fd < 0) return false;
+    size_t done = 0;
+    bool ok = ::fchmod(fd, 0644) == 0; // mkstemp creates it 0600
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n <= 0) { ok = false; break; }
+        done += (size_t)n;
+    }
+    ok = ok && ::fsync(fd) == 0;
+    ok = ::close(fd) == 0 && ok;
+#endif
+    error_code ec;
+    if (!ok) {
+        filesystem::remove(tmp, ec);
+        return false;
+    }
+
+    if (keepBackup && filesystem::exists(path, ec)) {
+        string bak = path + ".bak";
+        filesystem::remove(bak, ec);
+        filesystem::create_hard_link(path, bak, ec);
+        if (ec) filesystem::copy_file(path, bak, filesystem::copy_options::overwrite_existing, ec);
+    }
+    filesystem::rename(tmp, path, ec); // replaces path in one step
+    if (ec) {
+        filesystem::remove(tmp, ec);
+        return false;
+    }
+#ifndef _WIN32
+    // The rename itself is only durable once the folder is
+    string folder = filesystem::path(path).parent_path().string();
+    int dfd = ::open(folder.empty() ? "." : folder.c_str(), O_RDONLY);
+    if (dfd >= 0) {
+        ::fsync(dfd);
+        ::close(dfd);
+    }
+#endif
+    return true;
+}
+
+// Slicing-by-8: eight table lookups per 8 bytes instead of one per byte
+static const uint32_t (&crcTables())[8][256]
+{
+    static uint32_t t[8][256];
+    static bool built = [] {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[0][i] = c;
+        }
+        for (uint32_t i = 0; i < 256; ++i)
+            for (int s = 1; s < 8; ++s) t[s][i] = (t[s - 1][i] >> 8) ^ t[0][t[s - 1][i] & 0xFF];
+        return true;
+    }();
+    (void)built;
+    return t;
+}
+
+uint32_t FileUtil::crc32(string_view data, uint32_t crc)
+{
+    const uint32_t (&t)[8][256] = crcTables();
+    const unsigned char *p = reinterpret_cast<const unsigned char *>(data.data());
+    size_t n = data.size();
+    crc = ~crc;
+    while (n >= 8) {
+        uint32_t lo = crc ^ ((uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+            ^ t[3][p[4]] ^ t[2][p[5]] ^ t[1][p[6]] ^ t[0][p[7]];
+        p += 8;
+        n -= 8;
+    }
+    while (n--) crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+FileLock::FileLock(const string &path, bool exclusive)
+{
+#ifdef _WIN32
+    (void)path; (void)exclusive;
+    fd = 0; // no advisory locks, treat as held
+#else
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd >= 0 && ::flock(fd, exclusive ? LOCK_EX : LOCK_SH) != 0) {
+        ::close(fd);
+        fd = -1;
+    }
+#endif
+}
+
+FileLock::~FileLock()
+{
+#ifndef _WIN32
+    if (fd >= 0) ::close(fd); // closing releases the lock
+#endif
+}
+
+MappedFile::MappedFile(const string &path)
+{
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    opened = true;
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        void *p = ::mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p != MAP_FAILED) {
+            ::madvise(p, (size_t)st.st_size, MADV_SEQUENTIAL);
+            ptr = static_cast<const char *>(p);
+            len = (size_t)st.st_size;
+            mapped = true;
+        }
+    }
+    ::close(fd);
+    if (mapped || st.st_size == 0) return;
+#endif
+    // No mmap: read the file into memory instead
+    ifstream ifs(path, ios::binary);
+    if (!ifs) return;
+    opened = true;
+    fallback.assign(istreambuf_iterator<char>(ifs), istreambuf_iterator<char>());
+    ptr = fallback.data();
+    len = fallback.size();
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if (mapped) ::munmap(const_cast<char *>(ptr), len);
+#endif
+}
@@ -0,0 +1,96 @@
+#include "FileWatcher.hpp"
+#include <iostream>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+FileWatcher::FileWatcher(const string &folder, chrono::milliseconds pollInterval)
+    : folder(folder), pollInterval(pollInterval), lastPoll(chrono::steady_clock::now())
+{
+#ifdef __linux__
+    fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd >= 0) {
+        string dir = folder.empty() ? "." : folder;
+        uint32_t mask = IN_MODIFY | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_TO | IN_MOVED_FROM;
+        if (inotify_add_watch(fd, dir.c_str(), mask) < 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+    if (fd < 0) cerr << "FileWatcher: inotify unavailable for '" << folder << "', polling instead\n";
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#ifdef __linux__
+    if (fd >= 0) ::close(fd);
+#endif
+}
+
+void FileWatcher::watch(const string &name)
+{
+    files[name] = FileUtil::stamp(folder + name);
+}
+
+bool FileWatcher::check()
+{
+    if (fd >= 0) readEvents();
+    else pollStamps();
+    return !pending.empty();
+}
+
+vector<string> FileWatcher::take()
+{
+    vector<string> out(pending.begin(), pending.end());
+    pending.clear();
+    return out;
+}
+
+void FileWatcher::readEvents()
+{
+#ifdef __linux__
+    alignas(struct inotify_event) char buf[4096];
+    for (;;) {
+        ssize_t n = ::read(fd, buf, sizeof(buf));
+        if (n <= 0) {
+            if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                // Watch is broken (e.g. folder removed): keep going by polling
+                ::close(fd);
+                fd = -1;
+                for (auto &f : files) pending.insert(f.first);
+            }
+            return;
+        }
+        for (char *p = buf; p < buf + n;) {
+            const struct inotify_event *e = reinterpret_cast<const struct inotify_event *>(p);
+            if (e->mask & (IN_Q_OVERFLOW | IN_IGNORED)) {
+                for (auto &f : files) pending.insert(f.first); // lost events: treat everything as changed
+                if (e->mask & IN_IGNORED) { ::close(fd); fd = -1; return; }
+            } else if (e->len > 0) {
+                string name(e->name);
+                if (files.count(name)) pending.insert(name);
+            }
+            p += sizeof(struct inotify_event) + e->len;
+        }
+    }
+#endif
+}
+
+void FileWatcher::pollStamps()
+{
+    auto now = chrono::steady_clock::now();
+    if (now - lastPoll < pollInterval) return;
+    lastPoll = now;
+    for (auto &f : files) {
+        FileStamp s = FileUtil::stamp(folder + f.first);
+        if (s != f.second) {
+            f.second = s;
+            pending.insert(f.first);
+        }
+    }
+}
@@ -1,67 +1,159 @@
-#include "LoyaltyManager.hpp"
-#include "Persistence.hpp"
-#include <iostream>
-
-using namespace std;
-
-bool LoyaltyManager::isEligibleForDiscount(const Customer &c) {
-    return c.loyaltyPoints >= 1000;
-}
-
-void LoyaltyManager::processCheckout(Customer &c, vector<Order> &orders, bool useDiscount) {
-    
-    // Step 1: Get a unique Order ID for this entire transaction
-    // We use the same ID for all restaurants in this cart
-    int sharedOrderId = Persistence::getNextId("orders.txt");
-
-    // Step 2: Handle Discount Logic
-    bool discountApplied = false;
-    if (useDiscount && isEligibleForDiscount(c)) {
-        c.loyaltyPoints -= 1000; // Deduct points
-        discountApplied = true;
-    }
-
-    // Step 3: Process each order (one order per restaurant involved)
-    for (auto &ord : orders) {
-        // A. Assign the Shared ID
-        ord.id = sharedOrderId;
-        ord.customerId = c.id;
-        ord.status = "Placed"; // Default status
-
-        // B. Calculate Total & Apply Discount if needed
-        double orderTotal = 0.0;
-        for (auto &item : ord.items) {
-            // Recalculate item total just to be safe
-            double itemCost = item.unitPrice * item.qty;
-            orderTotal += itemCost;
-        }
-
-        if (discountApplied) {
-            // Apply 10% off (multiply by 0.90)
-            ord.total = orderTotal * 0.90;
-        } else {
-            ord.total = orderTotal;
-        }
-
-        // C. Save the Order to file
-        Persistence::saveOrder(ord);
-    }
-
-    // Step 4: Reward the customer
-    // We give +10 points for the transaction (regardless of size)
-    c.loyaltyPoints += 10;
-
-    // Step 5: Save the updated Customer data (Points changed)
-    // We need to update the specific customer in the full list
-    vector<Customer> allCustomers = Persistence::loadAllCustomers("customers.txt");
-    
-    for (auto &dbCust : allCustomers) {
-        if (dbCust.id == c.id) {
-            dbCust.loyaltyPoints = c.loyaltyPoints; // Update points
-            break;
-        }
-    }
-    
-    // Save everyone back to file
-    Persistence::saveAllCustomers(allCustomers, "customers.txt");
-}
\ No newline at end of file
+#include "LoyaltyManager.hpp"
+#include "Persistence.hpp"
+#include "Trace.hpp"
+#include "Metrics.hpp"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+
+using namespace std;
+
+bool LoyaltyManager::isEligibleForDiscount(const Customer &c) {
+    return c.loyaltyPoints >= 1000;
+}
+
+// Prices one checkout: shared order id, Placed status, totals with the discount.
+// discountApplied: the 1000 points were already spent on disk (spendLoyaltyPoints).
+// Updates the customer's points and returns the reward to journal.
+static int settleCheckout(Customer &c, vector<Order> &orders, int sharedOrderId, bool discountApplied) {
+
+    // Handle Discount Logic
+    if (discountApplied) {
+        c.loyaltyPoints -= 1000; // Deduct points (mirrors the journaled -1000)
+    }
+
+    // Process each order (one order per restaurant involved)
+    for (auto &ord : orders) {
+        // A. Assign the Shared ID
+        ord.id = sharedOrderId;
+        ord.customerId = c.id;
+        ord.status = OrderStatus::Placed; // Default status
+
+        // B. Calculate Total & Apply Discount if needed
+        Money orderTotal;
+        for (auto &item : ord.items) {
+            // Recalculate item total just to be safe
+            orderTotal += item.subtotal();
+        }
+
+        if (discountApplied) {
+            // Apply 10% off (90% of the total, rounded to the nearest paisa)
+            ord.total = orderTotal.percent(90);
+        } else {
+            ord.total = orderTotal;
+        }
+    }
+
+    // Reward the customer
+    // We give +10 points for the transaction (regardless of size)
+    c.loyaltyPoints += 10;
+    return 10;
+}
+
+// Metrics for placed orders (after they were saved). Each restaurant's counter is
+// looked up once per thread, so counting an order is a relaxed add without the registry lock.
+static void countPlaced(const vector<Order> &orders) {
+    thread_local unordered_map<int, Counter *> byRestaurant;
+    for (const auto &o : orders) {
+        Counter *&c = byRestaurant[o.restaurantId];
+        if (!c)
+            c = &Metrics::counter("sustieats_orders_placed_total", "Orders placed, per restaurant",
+                                  Metrics::label("restaurant", o.restaurantId));
+        c->add();
+    }
+}
+
+// A checkout whose orders could not be saved: undo settleCheckout and give the spent points back
+static void refundCheckout(Customer &c, int pointsDelta, bool discountApplied) {
+    c.loyaltyPoints -= pointsDelta;
+    if (discountApplied) c.loyaltyPoints += 1000;
+}
+
+bool LoyaltyManager::processCheckout(Customer &c, vector<Order> &orders, bool useDiscount) {
+    SE_TRACE_SCOPE("LoyaltyManager::processCheckout");
+    static Histogram &latency = Metrics::histogram("sustieats_checkout_duration_seconds",
+                                                   "processCheckout time: id, pricing, order and points appends");
+    auto start = chrono::steady_clock::now();
+
+    // Step 1: Get a unique Order ID for this entire transaction
+    // We use the same ID for all restaurants in this cart
+    int sharedOrderId = Persistence::allocateId("orders.txt");
+
+    // Step 2: Discount, totals and points. Whether the points can be spent is decided
+    // from the balance on disk, under the journal lock, never from our (maybe stale) copy
+    bool discount = useDiscount && Persistence::spendLoyaltyPoints({c.id}, 1000)[0];
+    int pointsDelta = settleCheckout(c, orders, sharedOrderId, discount);
+
+    // Step 3: Save the orders (one append for the whole cart)
+    if (!Persistence::saveOrders(orders)) {
+        refundCheckout(c, pointsDelta, discount);
+        if (discount) Persistence::addLoyaltyPoints(c.id, 1000);
+        return false;
+    }
+
+    // Step 4: Save the points change
+    // Only the delta is journaled, so concurrent checkouts never overwrite each other
+    Persistence::addLoyaltyPoints(c.id, pointsDelta);
+
+    countPlaced(orders);
+    latency.observeNs((uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    return true;
+}
+
+vector<Order> LoyaltyManager::processBatchCheckout(const vector<BatchCart> &carts) {
+    SE_TRACE_SCOPE("LoyaltyManager::processBatchCheckout");
+
+    // Step 1: Turn every non-empty cart into its orders (checkout empties the cart)
+    vector<vector<Order>> perCart(carts.size());
+    int cartCount = 0;
+    for (size_t i = 0; i < carts.size(); ++i) {
+        Customer *c = carts[i].customer;
+        if (!c) continue;
+        perCart[i] = c->checkout();
+        if (!perCart[i].empty()) cartCount++;
+    }
+    if (cartCount == 0) return {};
+
+    // Step 2: One block of ids, one id per cart
+    int nextId = Persistence::allocateId("orders.txt", cartCount);
+
+    // Step 3: Spend the points of every discounted cart in one locked pass, then price every cart
+    vector<int> spenders;
+    vector<size_t> spenderCart;
+    for (size_t i = 0; i < carts.size(); ++i) {
+        if (perCart[i].empty() || !carts[i].useDiscount) continue;
+        spenders.push_back(carts[i].customer->id);
+        spenderCart.push_back(i);
+    }
+    vector<bool> discount(carts.size(), false);
+    vector<bool> spent = Persistence::spendLoyaltyPoints(spenders, 1000);
+    for (size_t k = 0; k < spenders.size(); ++k) discount[spenderCart[k]] = spent[k];
+
+    vector<Order> placed;
+    vector<pair<int, int>> pointsDeltas;
+    for (size_t i = 0; i < carts.size(); ++i) {
+        if (perCart[i].empty()) continue;
+        Customer &c = *carts[i].customer;
+        pointsDeltas.emplace_back(c.id, settleCheckout(c, perCart[i], nextId++, discount[i]));
+        for (auto &o : perCart[i]) placed.push_back(move(o));
+    }
+    // Group by restaurant, so each restaurant's orders are contiguous in the log
+    stable_sort(placed.begin(), placed.end(), [](const Order &a, const Order &b) { return a.restaurantId < b.restaurantId; });
+
+    // Step 4: One append (and fsync) for the orders, one for the points
+    if (!Persistence::saveOrders(placed)) {
+        vector<pair<int, int>> refunds;
+        size_t k = 0;
+        for (size_t i = 0; i < carts.size(); ++i) {
+            if (perCart[i].empty()) continue;
+            refundCheckout(*carts[i].customer, pointsDeltas[k++].second, discount[i]);
+            if (discount[i]) refunds.emplace_back(carts[i].customer->id, 1000);
+        }
+        Persistence::addLoyaltyPoints(refunds);
+        return {};
+    }
+    Persistence::addLoyaltyPoints(pointsDeltas);
+    countPlaced(placed);
+    return placed;
+}
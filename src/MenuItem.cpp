@@ -1 +1 @@
-#include "MenuItem.hpp"
+#include "MenuItem.hpp"
@@ -0,0 +1,217 @@
+#include "Metrics.hpp"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+using namespace std;
+
+int Counter::shardIndex()
+{
+    static atomic<int> next{0};
+    thread_local int index = next.fetch_add(1, memory_order_relaxed) % SHARDS;
+    return index;
+}
+
+uint64_t Counter::value() const
+{
+    uint64_t total = 0;
+    for (const auto &s : shards) total += s.n.load(memory_order_relaxed);
+    return total;
+}
+
+Histogram::Histogram(const vector<double> &boundsSeconds) : boundsSec(boundsSeconds), buckets(boundsSeconds.size() + 1)
+{
+    for (double b : boundsSec) boundsNs.push_back((uint64_t)(b * 1e9));
+}
+
+void Histogram::observeNs(uint64_t ns)
+{
+    size_t i = 0;
+    while (i < boundsNs.size() && ns > boundsNs[i]) ++i; // le: upper bounds are inclusive
+    buckets[i].add();
+    sum.add(ns);
+}
+
+vector<uint64_t> Histogram::bucketCounts() const
+{
+    vector<uint64_t> out;
+    out.reserve(buckets.size());
+    for (const auto &b : buckets) out.push_back(b.value());
+    return out;
+}
+
+namespace
+{
+struct Metric
+{
+    unique_ptr<Counter> counter;
+    unique_ptr<Gauge> gauge;
+    unique_ptr<Histogram> histogram;
+};
+
+struct Family
+{
+    string help;
+    string type; // "counter", "gauge" or "histogram"
+    map<string, Metric> byLabels;
+};
+
+struct MetricsRegistry
+{
+    shared_mutex mtx;
+    map<string, Family> families; // by name, so the export is in a stable order
+    mutex collectMtx;
+    vector<function<void()>> collectors;
+};
+
+MetricsRegistry &registry()
+{
+    static MetricsRegistry r;
+    return r;
+}
+
+// Finds or creates name{labels}; make builds the metric the first time
+template <class Make>
+Metric &lookup(const string &name, const string &help, const char *type, const string &labels, Make make)
+{
+    MetricsRegistry &r = registry();
+    {
+        shared_lock<shared_mutex> lock(r.mtx);
+        auto f = r.families.find(name);
+        if (f != r.families.end()) {
+            auto m = f->second.byLabels.find(labels);
+            if (m != f->second.byLabels.end() && f->second.type == type) return m->second;
+        }
+    }
+    unique_lock<shared_mutex> lock(r.mtx);
+    Family &f = r.families[name];
+    if (f.type.empty()) {
+        f.help = help;
+        f.type = type;
+    } else if (f.type != type) {
+        throw logic_error("metric " + name + " is already registered as a " + f.type);
+    }
+    auto m = f.byLabels.find(labels);
+    if (m == f.byLabels.end()) {
+        m = f.byLabels.emplace(labels, Metric()).first;
+        make(m->second);
+    }
+    return m->second;
+}
+
+string number(double v)
+{
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.9g", v);
+    return buf;
+}
+
+// name{labels} with an extra label appended (for le)
+string series(const string &name, const string &labels, const string &extra = "")
+{
+    string all = labels;
+    if (!extra.empty()) all += (all.empty() ? "" : ",") + extra;
+    return all.empty() ? name : name + "{" + all + "}";
+}
+} // namespace
+
+const vector<double> &Metrics::latencyBuckets()
+{
+    static const vector<double> b = {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01,
+                                     0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10};
+    return b;
+}
+
+Counter &Metrics::counter(const string &name, const string &help, const string &labels)
+{
+    return *lookup(name, help, "counter", labels, [](Metric &m) { m.counter = make_unique<Counter>(); }).counter;
+}
+
+Gauge &Metrics::gauge(const string &name, const string &help, const string &labels)
+{
+    return *lookup(name, help, "gauge", labels, [](Metric &m) { m.gauge = make_unique<Gauge>(); }).gauge;
+}
+
+Histogram &Metrics::histogram(const string &name, const string &help, const string &labels, const vector<double> &boundsSeconds)
+{
+    return *lookup(name, help, "histogram", labels, [&](Metric &m) { m.histogram = make_unique<Histogram>(boundsSeconds); }).histogram;
+}
+
+string Metrics::label(const string &key, const string &value)
+{
+    string out = key + "=\"";
+    for (char c : value) {
+        if (c == '\\' || c == '"') out += '\\';
+        if (c == '\n') { out += "\\n"; continue; }
+        out += c;
+    }
+    return out + "\"";
+}
+
+void Metrics::addCollector(function<void()> collect)
+{
+    MetricsRegistry &r = registry();
+    lock_guard<mutex> lock(r.collectMtx);
+    r.collectors.push_back(move(collect));
+}
+
+string Metrics::prometheusText()
+{
+    MetricsRegistry &r = registry();
+    {
+        lock_guard<mutex> lock(r.collectMtx);
+        for (const auto &collect : r.collectors) collect();
+    }
+
+    string out;
+    shared_lock<shared_mutex> lock(r.mtx);
+    for (const auto &[name, f] : r.families) {
+        out += "# HELP " + name + " " + f.help + "\n";
+        out += "# TYPE " + name + " " + f.type + "\n";
+        for (const auto &[labels, m] : f.byLabels) {
+            if (m.counter) {
+                out += series(name, labels) + " " + to_string(m.counter->value()) + "\n";
+            } else if (m.gauge) {
+                out += series(name, labels) + " " + to_string(m.gauge->value()) + "\n";
+            } else if (m.histogram) {
+                const Histogram &h = *m.histogram;
+                vector<uint64_t> counts = h.bucketCounts();
+                uint64_t cumulative = 0;
+                for (size_t i = 0; i < counts.size(); ++i) {
+                    cumulative += counts[i];
+                    string le = i < h.bounds().size() ? number(h.bounds()[i]) : "+Inf";
+                    out += series(name + "_bucket", labels, "le=\"" + le + "\"") + " " + to_string(cumulative) + "\n";
+                }
+                out += series(name + "_sum", labels) + " " + number(h.sumNs() / 1e9) + "\n";
+                out += series(name + "_count", labels) + " " + to_string(cumulative) + "\n";
+            }
+        }
+    }
+    return out;
+}
+
+bool Metrics::writeFile(const string &path)
+{
+    string tmp = path + ".tmp";
+    {
+        ofstream ofs(tmp, ios::trunc | ios::binary);
+        string text = prometheusText();
+        ofs.write(text.data(), (streamsize)text.size());
+        if (!ofs) {
+            cerr << "Could not write " << tmp << "\n";
+            return false;
+        }
+    }
+    error_code ec;
+    filesystem::rename(tmp, path, ec);
+    if (ec) {
+        cerr << "Could not replace " << path << ": " << ec.message() << "\n";
+        return false;
+    }
+    return true;
+}
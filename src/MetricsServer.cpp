@@ -0,0 +1,134 @@
+#include "MetricsServer.hpp"
+#include "Metrics.hpp"
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0 // macOS: SIGPIPE is ignored per socket instead
+#endif
+
+using namespace std;
+
+MetricsServer::~MetricsServer() { stop(); }
+
+#ifdef _WIN32
+
+bool MetricsServer::start(int)
+{
+    cerr << "The metrics listener is not available on Windows; use a metrics file instead\n";
+    return false;
+}
+
+void MetricsServer::stop() {}
+void MetricsServer::run() {}
+void MetricsServer::serveClient(int) {}
+
+#else
+
+bool MetricsServer::start(int port)
+{
+    stop();
+    fd = ::socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        cerr << "Metrics listener: socket failed: " << strerror(errno) << "\n";
+        return false;
+    }
+    int yes = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons((uint16_t)port);
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || ::listen(fd, 8) != 0) {
+        cerr << "Metrics listener: cannot listen on 127.0.0.1:" << port << ": " << strerror(errno) << "\n";
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    socklen_t len = sizeof(addr);
+    ::getsockname(fd, reinterpret_cast<sockaddr *>(&addr), &len);
+    boundPort = ntohs(addr.sin_port);
+
+    stopping = false;
+    worker = thread(&MetricsServer::run, this);
+    return true;
+}
+
+void MetricsServer::stop()
+{
+    if (worker.joinable()) {
+        stopping = true;
+        worker.join();
+    }
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    boundPort = 0;
+}
+
+void MetricsServer::run()
+{
+    // Wakes up every 200 ms to notice stop()
+    while (!stopping) {
+        pollfd p{fd, POLLIN, 0};
+        if (::poll(&p, 1, 200) <= 0) continue;
+        int client = ::accept(fd, nullptr, nullptr);
+        if (client < 0) continue;
+        serveClient(client);
+        ::close(client);
+    }
+}
+
+static void sendAll(int fd, const string &data)
+{
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::send(fd, data.data() + done, data.size() - done, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        done += (size_t)n;
+    }
+}
+
+void MetricsServer::serveClient(int client)
+{
+#ifdef SO_NOSIGPIPE
+    int yes = 1;
+    ::setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &yes, sizeof(yes));
+#endif
+    // Read the request head (a scrape is a small GET), giving up after 2 s or 8 KiB
+    string request;
+    char buf[1024];
+    while (request.find("\r\n\r\n") == string::npos && request.size() < 8192) {
+        pollfd p{client, POLLIN, 0};
+        if (::poll(&p, 1, 2000) <= 0) return;
+        ssize_t n = ::recv(client, buf, sizeof(buf), 0);
+        if (n <= 0) return;
+        request.append(buf, (size_t)n);
+    }
+
+    string line = request.substr(0, request.find("\r\n"));
+    string status, body, type = "text/plain; charset=utf-8";
+    if (line.rfind("GET /metrics ", 0) == 0 || line.rfind("GET /metrics?", 0) == 0) {
+        status = "200 OK";
+        body = Metrics::prometheusText();
+        type = "text/plain; version=0.0.4; charset=utf-8";
+    } else if (line.rfind("GET ", 0) == 0) {
+        status = "404 Not Found";
+        body = "Only /metrics is served here\n";
+    } else {
+        status = "405 Method Not Allowed";
+        body = "GET only\n";
+    }
+    sendAll(client, "HTTP/1.1 " + status + "\r\nContent-Type: " + type + "\r\nContent-Length: " + to_string(body.size())
+                        + "\r\nConnection: close\r\n\r\n" + body);
+}
+
+#endif
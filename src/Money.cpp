@@ -0,0 +1,56 @@
+#include "Money.hpp"
+#include <charconv>
+using namespace std;
+
+Money Money::percent(int64_t pct) const
+{
+    int64_t scaled = p * pct;
+    int64_t q = scaled / 100, r = scaled % 100;
+    if (r >= 50) q++;
+    else if (r <= -50) q--;
+    return Money(q);
+}
+
+bool Money::parse(string_view text, Money &out)
+{
+    bool negative = !text.empty() && text[0] == '-';
+    if (negative) text.remove_prefix(1);
+    size_t dot = text.find('.');
+    string_view whole = text.substr(0, dot);
+    string_view frac = dot == string_view::npos ? string_view() : text.substr(dot + 1);
+    if (whole.empty() && frac.empty()) return false;
+
+    // from_chars would take a second '-' ("--5"); the sign was handled above
+    if (!whole.empty() && whole[0] == '-') return false;
+    int64_t rupees = 0;
+    if (!whole.empty()) {
+        auto res = from_chars(whole.data(), whole.data() + whole.size(), rupees);
+        if (res.ec != errc() || res.ptr != whole.data() + whole.size()) return false;
+    }
+    // Room for rupees * 100 plus up to 100 paisa (".995" rounds up to a full rupee)
+    if (rupees > (INT64_MAX - 100) / 100) return false;
+    int64_t paisa = 0;
+    for (size_t i = 0; i < frac.size(); ++i) {
+        char c = frac[i];
+        if (c < '0' || c > '9') return false;
+        if (i < 2) paisa = paisa * 10 + (c - '0');
+        else if (i == 2 && c >= '5') paisa++; // round the third decimal
+    }
+    if (frac.size() == 1) paisa *= 10;
+
+    int64_t total = rupees * 100 + paisa;
+    out = Money(negative ? -total : total);
+    return true;
+}
+
+string Money::str() const
+{
+    int64_t a = p < 0 ? -p : p;
+    string s = (p < 0 ? "-" : "") + to_string(a / 100);
+    int64_t cents = a % 100;
+    if (cents == 0) return s;
+    s += '.';
+    s += char('0' + cents / 10);
+    if (cents % 10 != 0) s += char('0' + cents % 10);
+    return s;
+}
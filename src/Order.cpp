@@ -1,32 +1,62 @@
-#include "Order.hpp"
-using namespace std;
-
-bool Order::place()
-{
-    if (items.empty()) return false;
-    double t = 0.0;
-    for (const auto &it : items) t += it.subtotal();
-    total = t;
-    status = "Placed";
-    return true;
-}
-
-// Only change to Dispatched if it is currently 'Placed'
-bool Order::dispatch()
-{
-    if (status == "Placed") {
-        status = "Dispatched";
-        return true;
-    }
-    return false;
-}
-
-// Only Cancel if it is 'Placed' (Cannot cancel if already Dispatched)
-bool Order::cancel()
-{
-    if (status == "Placed") {
-        status = "Cancelled";
-        return true;
-    }
-    return false;
-}
\ No newline at end of file
+#include "Order.hpp"
+using namespace std;
+
+static const char *STATUS_NAMES[ORDER_STATUS_COUNT] = {
+    "Placed", "Accepted", "Preparing", "Dispatched", "Delivered", "Cancelled", "Refunded",
+};
+
+#define BIT(s) (1u << (unsigned)OrderStatus::s)
+// ALLOWED[from] has a bit set for every status it may move to
+static const uint8_t ALLOWED[ORDER_STATUS_COUNT] = {
+    /* Placed     */ BIT(Accepted) | BIT(Dispatched) | BIT(Cancelled),
+    /* Accepted   */ BIT(Preparing) | BIT(Dispatched) | BIT(Cancelled),
+    /* Preparing  */ BIT(Dispatched),
+    /* Dispatched */ BIT(Delivered),
+    /* Delivered  */ BIT(Refunded),
+    /* Cancelled  */ 0,
+    /* Refunded   */ 0,
+};
+#undef BIT
+
+const char *toString(OrderStatus s)
+{
+    unsigned i = (unsigned)s;
+    return i < ORDER_STATUS_COUNT ? STATUS_NAMES[i] : "Unknown";
+}
+
+bool parseOrderStatus(string_view text, OrderStatus &out)
+{
+    for (int i = 0; i < ORDER_STATUS_COUNT; ++i) {
+        if (text == STATUS_NAMES[i]) {
+            out = (OrderStatus)i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool canTransition(OrderStatus from, OrderStatus to)
+{
+    unsigned f = (unsigned)from, t = (unsigned)to;
+    return f < ORDER_STATUS_COUNT && t < ORDER_STATUS_COUNT && (ALLOWED[f] & (1u << t));
+}
+
+bool Order::place()
+{
+    if (items.empty()) return false;
+    Money t;
+    for (const auto &it : items) t += it.subtotal();
+    total = t;
+    status = OrderStatus::Placed;
+    version = 0;
+    return true;
+}
+
+// e.g. only dispatch a 'Placed' order, never cancel a dispatched one
+bool Order::transitionTo(OrderStatus next)
+{
+    if (!canTransition(status, next)) return false;
+    status = next;
+    version++;
+    return true;
+}
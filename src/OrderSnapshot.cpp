@@ -0,0 +1,205 @@
+#include "OrderSnapshot.hpp"
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+using namespace std;
+
+static const char MAGIC[4] = {'S', 'E', 'O', 'S'};
+static const uint32_t ENDIAN_TAG = 0x01020304;
+
+static size_t align8(size_t n) { return (n + 7) & ~(size_t)7; }
+
+// byte length of every section for the given counts
+static void sectionSizes(uint64_t orders, uint64_t items, uint64_t strings, uint64_t stringBytes, uint64_t out[])
+{
+    out[OrderSnapshotHeader::Id] = orders * 4;
+    out[OrderSnapshotHeader::CustomerId] = orders * 4;
+    out[OrderSnapshotHeader::RestaurantId] = orders * 4;
+    out[OrderSnapshotHeader::Status] = orders;
+    out[OrderSnapshotHeader::Total] = orders * 8;
+    out[OrderSnapshotHeader::Version] = orders * 4;
+    out[OrderSnapshotHeader::ItemStart] = (orders + 1) * 4;
+    out[OrderSnapshotHeader::ItemMenuId] = items * 4;
+    out[OrderSnapshotHeader::ItemName] = items * 4;
+    out[OrderSnapshotHeader::ItemQty] = items * 4;
+    out[OrderSnapshotHeader::ItemUnitPrice] = items * 8;
+    out[OrderSnapshotHeader::StringStart] = (strings + 1) * 4;
+    out[OrderSnapshotHeader::StringData] = stringBytes;
+}
+
+bool OrderSnapshot::write(const string &path, const vector<Order> &orders)
+{
+    // Number the item names used in this file (they are already interned in memory)
+    vector<string_view> strings;
+    unordered_map<Symbol, uint32_t> stringIds;
+    auto intern = [&](Symbol s) {
+        auto it = stringIds.find(s);
+        if (it != stringIds.end()) return it->second;
+        uint32_t idx = (uint32_t)strings.size();
+        strings.push_back(s.str());
+        stringIds.emplace(s, idx);
+        return idx;
+    };
+
+    uint64_t itemCount = 0;
+    for (const auto &o : orders) {
+        for (const auto &it : o.items) intern(it.itemSnapshot.name);
+        itemCount += o.items.size();
+    }
+    uint64_t stringBytes = 0;
+    for (auto s : strings) stringBytes += s.size();
+
+    OrderSnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, MAGIC, 4);
+    h.version = OrderSnapshotView::VERSION;
+    h.byteOrder = ENDIAN_TAG;
+    h.headerSize = sizeof(h);
+    h.orderCount = orders.size();
+    h.itemCount = itemCount;
+    h.stringCount = strings.size();
+
+    uint64_t sizes[OrderSnapshotHeader::SectionCount];
+    sectionSizes(h.orderCount, h.itemCount, h.stringCount, stringBytes, sizes);
+    size_t offset = sizeof(h);
+    for (int s = 0; s < OrderSnapshotHeader::SectionCount; ++s) {
+        h.sections[s] = offset;
+        offset = align8(offset + sizes[s]);
+    }
+    h.fileSize = offset;
+
+    string buf(h.fileSize, '\0');
+    memcpy(&buf[0], &h, sizeof(h));
+    auto col = [&](int section) { return &buf[h.sections[section]]; };
+    int32_t *id = reinterpret_cast<int32_t *>(col(OrderSnapshotHeader::Id));
+    int32_t *customerId = reinterpret_cast<int32_t *>(col(OrderSnapshotHeader::CustomerId));
+    int32_t *restaurantId = reinterpret_cast<int32_t *>(col(OrderSnapshotHeader::RestaurantId));
+    uint8_t *status = reinterpret_cast<uint8_t *>(col(OrderSnapshotHeader::Status));
+    int64_t *total = reinterpret_cast<int64_t *>(col(OrderSnapshotHeader::Total));
+    int32_t *version = reinterpret_cast<int32_t *>(col(OrderSnapshotHeader::Version));
+    uint32_t *itemStart = reinterpret_cast<uint32_t *>(col(OrderSnapshotHeader::ItemStart));
+    int32_t *itemMenuId = reinterpret_cast<int32_t *>(col(OrderSnapshotHeader::ItemMenuId));
+    uint32_t *itemName = reinterpret_cast<uint32_t *>(col(OrderSnapshotHeader::ItemName));
+    int32_t *itemQty = reinterpret_cast<int32_t *>(col(OrderSnapshotHeader::ItemQty));
+    int64_t *itemUnitPrice = reinterpret_cast<int64_t *>(col(OrderSnapshotHeader::ItemUnitPrice));
+    uint32_t *stringStart = reinterpret_cast<uint32_t *>(col(OrderSnapshotHeader::StringStart));
+    char *stringData = col(OrderSnapshotHeader::StringData);
+
+    uint32_t j = 0;
+    for (size_t i = 0; i < orders.size(); ++i) {
+        const Order &o = orders[i];
+        id[i] = o.id;
+        customerId[i] = o.customerId;
+        restaurantId[i] = o.restaurantId;
+        status[i] = (uint8_t)o.status;
+        total[i] = o.total.paisa();
+        version[i] = o.version;
+        itemStart[i] = j;
+        for (const auto &it : o.items) {
+            itemMenuId[j] = it.itemSnapshot.id;
+            itemName[j] = stringIds[it.itemSnapshot.name];
+            itemQty[j] = it.qty;
+            itemUnitPrice[j] = it.unitPrice.paisa();
+            ++j;
+        }
+    }
+    itemStart[orders.size()] = j;
+
+    uint32_t pos = 0;
+    for (size_t s = 0; s < strings.size(); ++s) {
+        stringStart[s] = pos;
+        memcpy(stringData + pos, strings[s].data(), strings[s].size());
+        pos += (uint32_t)strings[s].size();
+    }
+    stringStart[strings.size()] = pos;
+
+    // Replaced by rename, not truncated in place: a reader that has the old file
+    // mapped keeps a whole copy until it reopens
+    return FileUtil::replaceDurable(path, buf);
+}
+
+vector<Order> OrderSnapshot::read(const string &path)
+{
+    vector<Order> out;
+    OrderSnapshotView view;
+    if (!view.open(path)) return out;
+    out.reserve(view.size());
+    for (size_t i = 0; i < view.size(); ++i) out.push_back(view.order(i));
+    return out;
+}
+
+bool OrderSnapshotView::open(const string &path)
+{
+    file = make_unique<MappedFile>(path);
+    header = nullptr;
+    orders = 0;
+    if (!file->isOpen()) return false;
+
+    string_view data = file->view();
+    const OrderSnapshotHeader *h = reinterpret_cast<const OrderSnapshotHeader *>(data.data());
+    auto bad = [&](const char *why) {
+        cerr << "Bad order snapshot " << path << ": " << why << "\n";
+        return false;
+    };
+    if (data.size() < sizeof(OrderSnapshotHeader) || memcmp(h->magic, MAGIC, 4) != 0) return bad("not an order snapshot");
+    if (h->byteOrder != ENDIAN_TAG) return bad("written on a machine with another byte order");
+    if (h->version != VERSION) return bad("unsupported version");
+    if (h->headerSize != sizeof(OrderSnapshotHeader) || h->fileSize != data.size()) return bad("truncated");
+
+    // Every record takes at least this many bytes across its columns, so larger
+    // counts cannot fit; checking first keeps sectionSizes from overflowing
+    const uint64_t perOrder = 4 + 4 + 4 + 1 + 8 + 4 + 4, perItem = 4 + 4 + 4 + 8, perString = 4;
+    if (h->orderCount > data.size() / perOrder || h->itemCount > data.size() / perItem || h->stringCount > data.size() / perString)
+        return bad("counts larger than the file");
+    uint64_t sizes[OrderSnapshotHeader::SectionCount];
+    sectionSizes(h->orderCount, h->itemCount, h->stringCount, 0, sizes);
+    for (int s = 0; s < OrderSnapshotHeader::SectionCount; ++s) {
+        if (h->sections[s] % 8 != 0 || h->sections[s] < sizeof(OrderSnapshotHeader) || h->sections[s] > data.size()
+            || sizes[s] > data.size() - h->sections[s])
+            return bad("section out of range");
+    }
+    header = h;
+    orders = h->orderCount;
+
+    // Offsets must be monotonic so item and string ranges stay inside the file
+    const uint32_t *itemStart = col<uint32_t>(OrderSnapshotHeader::ItemStart);
+    for (size_t i = 0; i < orders; ++i)
+        if (itemStart[i] > itemStart[i + 1]) { header = nullptr; orders = 0; return bad("item index"); }
+    const uint32_t *stringStart = col<uint32_t>(OrderSnapshotHeader::StringStart);
+    for (size_t s = 0; s < h->stringCount; ++s)
+        if (stringStart[s] > stringStart[s + 1]) { header = nullptr; orders = 0; return bad("string index"); }
+    if (itemStart[orders] != h->itemCount || h->sections[OrderSnapshotHeader::StringData] + stringStart[h->stringCount] > data.size()) {
+        header = nullptr;
+        orders = 0;
+        return bad("column lengths");
+    }
+    return true;
+}
+
+string_view OrderSnapshotView::str(uint32_t index) const
+{
+    if (index >= header->stringCount) return string_view();
+    const uint32_t *start = col<uint32_t>(OrderSnapshotHeader::StringStart);
+    return string_view(col<char>(OrderSnapshotHeader::StringData) + start[index], start[index + 1] - start[index]);
+}
+
+Order OrderSnapshotView::order(size_t i) const
+{
+    Order o;
+    o.id = id(i);
+    o.customerId = customerId(i);
+    o.restaurantId = restaurantId(i);
+    o.status = status(i);
+    o.total = total(i);
+    o.version = version(i);
+    o.items.reserve(itemEnd(i) - itemBegin(i));
+    for (size_t j = itemBegin(i); j < itemEnd(i); ++j) {
+        OrderItem it;
+        it.itemSnapshot.id = itemMenuId(j);
+        it.itemSnapshot.name = itemName(j);
+        it.qty = itemQty(j);
+        it.unitPrice = itemUnitPrice(j);
+        o.items.push_back(move(it));
+    }
+    return o;
+}
@@ -0,0 +1,110 @@
+#include "OrderStore.hpp"
+#include "Persistence.hpp"
+#include "Metrics.hpp"
+using namespace std;
+
+static Counter &reloadCounter(const char *kind)
+{
+    return Metrics::counter("sustieats_order_reloads_total",
+                            "OrderStore reloads: full (snapshot reparsed) or incremental (new log records only)",
+                            Metrics::label("kind", kind));
+}
+
+OrderStore::OrderStore(const string &filename) : filename(filename)
+{
+    reload();
+}
+
+void OrderStore::reload()
+{
+    string logPath = Persistence::dataFolder + Persistence::orderLogName(filename);
+    // Stamp before reading: anything written in between is picked up (again) by the
+    // next refresh, which is harmless because log replay is idempotent.
+    snapshotStamp = FileUtil::stamp(Persistence::dataFolder + filename);
+    logStamp = FileUtil::stamp(logPath);
+
+    list = Persistence::loadOrderSnapshot(filename);
+    byKey.clear();
+    byKey.reserve(list.size());
+    for (size_t i = 0; i < list.size(); ++i) byKey[list[i].key()] = i;
+
+    logOffset = Persistence::applyOrderLog(FileUtil::readFrom(logPath, 0), list, byKey);
+    byCustomer.clear();
+    byRestaurant.clear();
+    indexFrom(0);
+    gen++;
+    static Counter &full = reloadCounter("full");
+    full.add();
+}
+
+bool OrderStore::refresh()
+{
+    string logPath = Persistence::dataFolder + Persistence::orderLogName(filename);
+    FileStamp snap = FileUtil::stamp(Persistence::dataFolder + filename);
+    FileStamp log = FileUtil::stamp(logPath);
+
+    // The snapshot only changes when it is rewritten as a whole
+    if (snap != snapshotStamp) { reload(); return true; }
+    if (log == logStamp) return false;
+
+    bool replaced = logStamp.exists && log.exists && log.inode != logStamp.inode;
+    if (!log.exists || log.size < logOffset || replaced) { reload(); return true; }
+
+    // Appended: parse only the new records
+    static Counter &incremental = reloadCounter("incremental");
+    incremental.add();
+    size_t before = list.size();
+    size_t used = Persistence::applyOrderLog(FileUtil::readFrom(logPath, logOffset), list, byKey);
+    indexFrom(before); // replayed records for known orders update in place, new ones are appended
+    logOffset += used;
+    logStamp = log;
+    if (used == 0) return false;
+    gen++;
+    return true;
+}
+
+Order *OrderStore::find(int id, int restaurantId)
+{
+    auto it = byKey.find(Order::makeKey(id, restaurantId));
+    return it == byKey.end() ? nullptr : &list[it->second];
+}
+
+StatusChange OrderStore::changeStatus(int id, int restaurantId, OrderStatus next, int expectedVersion)
+{
+    refresh();
+    Order *o = find(id, restaurantId);
+    if (!o) return StatusChange::NotFound;
+    if (o->version != expectedVersion) return StatusChange::Conflict;
+    Order changed = *o;
+    if (!changed.transitionTo(next)) return StatusChange::NotAllowed;
+    if (!Persistence::appendOrderStatus(changed, filename)) return StatusChange::WriteFailed;
+
+    // Replay up to and including our record; the log order decides who won
+    refresh();
+    o = find(id, restaurantId);
+    bool won = o && o->version == changed.version && o->status == next;
+    Persistence::compactOrdersIfDue(filename);
+    return won ? StatusChange::Applied : StatusChange::Conflict;
+}
+
+static const vector<size_t> NO_ORDERS;
+
+const vector<size_t> &OrderStore::ordersForCustomer(int customerId) const
+{
+    auto it = byCustomer.find(customerId);
+    return it == byCustomer.end() ? NO_ORDERS : it->second;
+}
+
+const vector<size_t> &OrderStore::ordersForRestaurant(int restaurantId) const
+{
+    auto it = byRestaurant.find(restaurantId);
+    return it == byRestaurant.end() ? NO_ORDERS : it->second;
+}
+
+void OrderStore::indexFrom(size_t first)
+{
+    for (size_t i = first; i < list.size(); ++i) {
+        byCustomer[list[i].customerId].push_back(i);
+        byRestaurant[list[i].restaurantId].push_back(i);
+    }
+}
@@ -1,337 +1,855 @@
-#include "Persistence.hpp"
-#include <fstream>
-#include <sstream>
-#include <filesystem>
-#include <iostream>
-#include <stdexcept> 
-
-using namespace std;
-
-string Persistence::dataFolder = "data/";
-
-void Persistence::ensureDataFolderExists()
-{
-    if (!filesystem::exists(dataFolder)) {
-        filesystem::create_directories(dataFolder);
-    }
-}
-
-int Persistence::getNextId(const string &filename)
-{
-    ensureDataFolderExists();
-    ifstream ifs(dataFolder + filename);
-    if (!ifs) return 100; 
-
-    int maxId = 99;
-    string line;
-    while (getline(ifs, line))
-    {
-        if (line.empty()) continue;
-        try {
-            size_t pipePos = line.find('|');
-            if (pipePos != string::npos) {
-                string idStr = line.substr(0, pipePos);
-                int currId = stoi(idStr);
-                if (currId > maxId) maxId = currId;
-            }
-        } catch (...) {}
-    }
-    return maxId + 1;
-}
-
-// --- NEW: Verify Admin ---
-bool Persistence::verifyAdmin(int id, const string &password, const string &filename) {
-    ensureDataFolderExists();
-    ifstream ifs(dataFolder + filename);
-    if (!ifs) return false;
-    string line;
-    while(getline(ifs, line)) {
-        if(line.empty()) continue;
-        stringstream ss(line);
-        string token; 
-        getline(ss, token, '|'); // ID
-        if(stoi(token) == id) {
-            getline(ss, token, '|'); // Name (skip)
-            getline(ss, token, '|'); // Password
-            if(token == password) return true;
-        }
-    }
-    return false;
-}
-
-// ----------------- Customers -----------------
-void Persistence::saveCustomer(const Customer &c, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::app);
-    if (!ofs) return;
-    ofs << c.id << "|" << c.name << "|" << c.email << "|" << c.phone << "|" 
-        << c.password << "|" << (c.isActive ? 1 : 0) << "|" << c.loyaltyPoints << "\n";
-}
-
-void Persistence::saveAllCustomers(const vector<Customer> &customers, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::trunc); 
-    if (!ofs) return;
-    for (const auto &c : customers)
-    {
-        ofs << c.id << "|" << c.name << "|" << c.email << "|" << c.phone << "|" 
-            << c.password << "|" << (c.isActive ? 1 : 0) << "|" << c.loyaltyPoints << "\n";
-    }
-}
-
-vector<Customer> Persistence::loadAllCustomers(const string &filename)
-{
-    ensureDataFolderExists();
-    vector<Customer> out;
-    ifstream ifs(dataFolder + filename);
-    if (!ifs) return out;
-
-    string line;
-    while (getline(ifs, line))
-    {
-        if (line.empty()) continue;
-        try {
-            istringstream iss(line);
-            string token;
-            Customer c;
-            getline(iss, token, '|');
-            if (token.empty() || token == " ") continue; 
-            c.id = stoi(token);
-            getline(iss, c.name, '|');
-            getline(iss, c.email, '|');
-            getline(iss, c.phone, '|');
-            getline(iss, c.password, '|');
-            getline(iss, token, '|');
-            c.isActive = (token == "1");
-            getline(iss, token, '|');
-            if (!token.empty()) c.loyaltyPoints = stoi(token);
-            else c.loyaltyPoints = 0;
-            out.push_back(c);
-        } catch (...) { cerr << "Skipped bad customer line\n"; }
-    }
-    return out;
-}
-
-// ----------------- Owners -----------------
-void Persistence::saveOwner(const Owner &o, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::app);
-    if (!ofs) return;
-    ofs << o.id << "|" << o.name << "|" << o.email << "|" << o.phone << "|" 
-        << o.password << "|" << (o.isActive ? 1 : 0) << "\n";
-}
-
-// --- NEW: Save All Owners ---
-void Persistence::saveAllOwners(const vector<Owner> &owners, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::trunc);
-    if (!ofs) return;
-    for (const auto &o : owners)
-    {
-        ofs << o.id << "|" << o.name << "|" << o.email << "|" << o.phone << "|" 
-            << o.password << "|" << (o.isActive ? 1 : 0) << "\n";
-    }
-}
-
-vector<Owner> Persistence::loadAllOwners(const string &filename)
-{
-    ensureDataFolderExists();
-    vector<Owner> out;
-    ifstream ifs(dataFolder + filename);
-    if (!ifs) return out;
-
-    string line;
-    while (getline(ifs, line))
-    {
-        if (line.empty()) continue;
-        try {
-            istringstream iss(line);
-            string token;
-            Owner o;
-            getline(iss, token, '|');
-            if (token.empty()) continue;
-            o.id = stoi(token);
-            getline(iss, o.name, '|');
-            getline(iss, o.email, '|');
-            getline(iss, o.phone, '|');
-            getline(iss, o.password, '|');
-            getline(iss, token, '|');
-            o.isActive = (token == "1");
-            out.push_back(o);
-        } catch (...) { cerr << "Skipped bad owner line\n"; }
-    }
-    return out;
-}
-
-// ----------------- Restaurants -----------------
-void Persistence::saveRestaurant(const Restaurant &r, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::app);
-    if (!ofs) return;
-    ostringstream oss;
-    oss << r.id << "|" << r.name << "|" << r.address.line1 << "|" 
-        << r.address.city << "|" << r.address.postalCode << "|" 
-        << r.ownerId << "|" << r.menu.size();
-    for (const auto &mi : r.menu)
-    {
-        oss << "|" << mi.id << "," << mi.name << "," << mi.price << "," << (mi.available ? 1 : 0);
-    }
-    ofs << oss.str() << "\n";
-}
-
-vector<Restaurant> Persistence::loadAllRestaurants(const string &filename)
-{
-    ensureDataFolderExists();
-    vector<Restaurant> out;
-    ifstream ifs(dataFolder + filename);
-    if (!ifs) return out;
-
-    string line;
-    while (getline(ifs, line))
-    {
-        if (line.empty()) continue;
-        try {
-            istringstream iss(line);
-            string token;
-            Restaurant r;
-            getline(iss, token, '|');
-            if (token.empty()) continue;
-            r.id = stoi(token);
-            getline(iss, r.name, '|');
-            getline(iss, r.address.line1, '|');
-            getline(iss, r.address.city, '|');
-            getline(iss, r.address.postalCode, '|');
-            getline(iss, token, '|');
-            r.ownerId = stoi(token);
-            getline(iss, token, '|');
-            int menuCount = stoi(token);
-            for (int i = 0; i < menuCount; ++i)
-            {
-                getline(iss, token, '|'); 
-                istringstream mit(token);
-                string field;
-                MenuItem mi;
-                getline(mit, field, ',');
-                mi.id = stoi(field);
-                getline(mit, mi.name, ',');
-                getline(mit, field, ',');
-                getline(mit, field, ',');
-                mi.price = stod(field);
-                getline(mit, field, ',');
-                mi.available = (field == "1");
-                r.menu.push_back(mi);
-            }
-            out.push_back(r);
-        } catch (...) { cerr << "Skipped bad restaurant line\n"; }
-    }
-    return out;
-}
-
-void Persistence::saveAllRestaurants(const vector<Restaurant> &restaurants, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::trunc);
-    if (!ofs) return;
-    for (const auto &r : restaurants)
-    {
-        ostringstream oss;
-        oss << r.id << "|" << r.name << "|" << r.address.line1 << "|" 
-            << r.address.city << "|" << r.address.postalCode << "|" 
-            << r.ownerId << "|" << r.menu.size();
-        for (const auto &mi : r.menu)
-        {
-            oss << "|" << mi.id << "," << mi.name <<"," << mi.price << "," << (mi.available ? 1 : 0);
-        }
-        ofs << oss.str() << "\n";
-    }
-}
-
-// ----------------- Orders -----------------
-void Persistence::saveOrder(const Order &o, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::app);
-    if (!ofs) return;
-    ostringstream oss;
-    oss << o.id << "|" << o.customerId << "|" << o.restaurantId << "|" 
-        << o.status << "|" << o.total << "|" << o.items.size();
-    for (const auto &it : o.items)
-    {
-        oss << "|" << it.itemSnapshot.id << "," << it.itemSnapshot.name 
-            << "," << it.qty << "," << it.unitPrice;
-    }
-    ofs << oss.str() << "\n";
-}
-
-void Persistence::saveAllOrders(const vector<Order> &orders, const string &filename)
-{
-    ensureDataFolderExists();
-    ofstream ofs(dataFolder + filename, ios::trunc); // Overwrite file
-    if (!ofs) return;
-
-    for (const auto &o : orders)
-    {
-        ostringstream oss;
-        oss << o.id << "|" << o.customerId << "|" << o.restaurantId << "|" 
-            << o.status << "|" << o.total << "|" << o.items.size();
-        for (const auto &it : o.items)
-        {
-            oss << "|" << it.itemSnapshot.id << "," << it.itemSnapshot.name 
-                << "," << it.qty << "," << it.unitPrice;
-        }
-        ofs << oss.str() << "\n";
-    }
-}
-
-vector<Order> Persistence::loadAllOrders(const string &filename)
-{
-    ensureDataFolderExists();
-    vector<Order> out;
-    ifstream ifs(dataFolder + filename);
-    if (!ifs) return out;
-
-    string line;
-    while (getline(ifs, line))
-    {
-        if (line.empty()) continue;
-        try {
-            istringstream iss(line);
-            string token;
-            Order o;
-            getline(iss, token, '|');
-            if (token.empty()) continue;
-            o.id = stoi(token);
-            getline(iss, token, '|');
-            o.customerId = stoi(token);
-            getline(iss, token, '|');
-            o.restaurantId = stoi(token);
-            getline(iss, o.status, '|');
-            getline(iss, token, '|');
-            o.total = stod(token);
-            getline(iss, token, '|');
-            int itemCount = stoi(token);
-            for (int i = 0; i < itemCount; ++i)
-            {
-                getline(iss, token, '|');
-                istringstream mit(token);
-                string field;
-                OrderItem it;
-                getline(mit, field, ',');
-                it.itemSnapshot.id = stoi(field);
-                getline(mit, it.itemSnapshot.name, ',');
-                getline(mit, field, ',');
-                it.qty = stoi(field);
-                getline(mit, field, ',');
-                it.unitPrice = stod(field);
-                o.items.push_back(it);
-            }
-            out.push_back(o);
-        } catch (...) { cerr << "Skipped bad order line\n"; }
-    }
-    return out;
-}
\ No newline at end of file
+#include "Persistence.hpp"
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept> 
+#include <unordered_map>
+#include <string_view>
+#include <charconv>
+#include <algorithm>
+#include <cstdio>
+#include "FileUtil.hpp"
+#include "Metrics.hpp"
+#include "OrderSnapshot.hpp"
+#include "Trace.hpp"
+
+using namespace std;
+
+string Persistence::dataFolder = "data/";
+
+// ----------------- Metrics -----------------
+// Labelled counters are looked up in the registry once per thread and label value and
+// kept in a thread-local table, so an append costs a hash lookup and a relaxed add:
+// no registry lock and no label string.
+
+// Bytes handed to the OS per data file (appends and rewrites)
+static void countWritten(const string &filename, uintmax_t bytes)
+{
+    thread_local unordered_map<string, Counter *> byFile;
+    Counter *&c = byFile[filename];
+    if (!c)
+        c = &Metrics::counter("sustieats_persistence_bytes_written_total", "Bytes written to the data files by Persistence",
+                              Metrics::label("file", filename));
+    c->add(bytes);
+}
+
+// Status changes per restaurant
+static void countStatusChange(OrderStatus status, int restaurantId)
+{
+    thread_local unordered_map<int, Counter *> dispatched, cancelled;
+    if (status == OrderStatus::Dispatched) {
+        Counter *&c = dispatched[restaurantId];
+        if (!c)
+            c = &Metrics::counter("sustieats_orders_dispatched_total", "Orders dispatched, per restaurant",
+                                  Metrics::label("restaurant", restaurantId));
+        c->add();
+    } else if (status == OrderStatus::Cancelled) {
+        Counter *&c = cancelled[restaurantId];
+        if (!c)
+            c = &Metrics::counter("sustieats_orders_cancelled_total", "Orders cancelled, per restaurant",
+                                  Metrics::label("restaurant", restaurantId));
+        c->add();
+    }
+}
+
+// File sizes are read when metrics are exported, not on every write
+static void collectFileSizes()
+{
+    for (const char *name : {"customers.txt", "customers.txt.points", "owners.txt", "restaurants.txt",
+                             "orders.txt", "orders.txt.log", "orders.bin"})
+        Metrics::gauge("sustieats_data_file_bytes", "Size of each data file", Metrics::label("file", name))
+            .set((int64_t)FileUtil::fileSize(Persistence::dataFolder + name));
+}
+[[maybe_unused]] static const bool fileSizesCollected = (Metrics::addCollector(collectFileSizes), true);
+
+void Persistence::ensureDataFolderExists()
+{
+    if (!filesystem::exists(dataFolder)) {
+        filesystem::create_directories(dataFolder);
+    }
+}
+
+int Persistence::getNextId(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::getNextId");
+    ensureDataFolderExists();
+    ifstream ifs(dataFolder + filename);
+    int maxId = 99; // empty tables start at 100
+    string line;
+    while (ifs && getline(ifs, line))
+    {
+        if (line.empty() || line[0] == '#') continue;
+        try {
+            size_t pipePos = line.find('|');
+            if (pipePos != string::npos) {
+                string idStr = line.substr(0, pipePos);
+                int currId = stoi(idStr);
+                if (currId > maxId) maxId = currId;
+            }
+        } catch (...) {}
+    }
+
+    // Orders placed since the last compaction only exist in the event log
+    ifstream lfs(dataFolder + orderLogName(filename));
+    while (lfs && getline(lfs, line))
+    {
+        if (line.size() < 3 || line[0] != 'P' || line[1] != '|') continue;
+        try {
+            int currId = stoi(line.substr(2, line.find('|', 2) - 2));
+            if (currId > maxId) maxId = currId;
+        } catch (...) {}
+    }
+    return maxId + 1;
+}
+
+int Persistence::allocateId(const string &filename, int count)
+{
+    SE_TRACE_SCOPE("Persistence::allocateId");
+    ensureDataFolderExists();
+    int first = -1;
+    bool ok = FileUtil::updateLocked(dataFolder + filename + ".seq", [&](const string &current) {
+        int next = 0;
+        if (from_chars(current.data(), current.data() + current.size(), next).ec != errc() || next <= 0)
+            next = getNextId(filename); // first use: start after the highest id on disk
+        first = next;
+        return to_string(next + count) + "\n";
+    });
+    if (!ok) {
+        cerr << "Could not update id sequence for " << filename << ", falling back to a scan\n";
+        return getNextId(filename);
+    }
+    return first;
+}
+
+// --- NEW: Verify Admin ---
+bool Persistence::verifyAdmin(int id, const string &password, const string &filename) {
+    ensureDataFolderExists();
+    ifstream ifs(dataFolder + filename);
+    if (!ifs) return false;
+    string line;
+    while(getline(ifs, line)) {
+        if(line.empty()) continue;
+        stringstream ss(line);
+        string token; 
+        getline(ss, token, '|'); // ID
+        if(stoi(token) == id) {
+            getline(ss, token, '|'); // Name (skip)
+            getline(ss, token, '|'); // Password
+            if(token == password) return true;
+        }
+    }
+    return false;
+}
+
+// ----------------- Parsing helpers -----------------
+// The loaders slice a memory-mapped copy of the file with string_view and parse
+// numbers with from_chars, so the only allocations are the strings the objects keep.
+
+// next line without its "\n" / "\r\n"; advances text past it
+static string_view nextLine(string_view &text)
+{
+    size_t nl = text.find('\n');
+    string_view line = text.substr(0, nl);
+    text.remove_prefix(nl == string_view::npos ? text.size() : nl + 1);
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+    return line;
+}
+
+// field up to delim; advances s past it (same as getline on a stringstream)
+static string_view nextField(string_view &s, char delim)
+{
+    size_t pos = s.find(delim);
+    string_view field = s.substr(0, pos);
+    s.remove_prefix(pos == string_view::npos ? s.size() : pos + 1);
+    return field;
+}
+
+static bool parseInt(string_view f, int &out)
+{
+    while (!f.empty() && f.front() == ' ') f.remove_prefix(1);
+    return from_chars(f.data(), f.data() + f.size(), out).ec == errc();
+}
+
+// Prices and totals: "120" or "607.5" (rupees), exact to the paisa
+static bool parseMoney(string_view f, Money &out)
+{
+    while (!f.empty() && f.front() == ' ') f.remove_prefix(1);
+    while (!f.empty() && f.back() == ' ') f.remove_suffix(1);
+    return Money::parse(f, out);
+}
+
+// ----------------- Table files -----------------
+string Persistence::checksumFooter(uint32_t crc, uint64_t length)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "#crc32=%08x len=%llu\n", crc, (unsigned long long)length);
+    return buf;
+}
+
+DataFileCheck Persistence::checkDataFile(const string &filename)
+{
+    MappedFile file(dataFolder + filename);
+    if (!file.isOpen()) return DataFileCheck::Missing;
+    string_view text = file.view();
+    if (text.empty()) return DataFileCheck::Corrupt;
+
+    // The footer is the first '#crc32=' line; rows appended after it are not covered
+    size_t pos = text.substr(0, 7) == "#crc32=" ? 0 : text.find("\n#crc32=");
+    if (pos == string_view::npos) {
+        // Once a table has been saved with a checksum it always has one, so a file
+        // without it next to a checksummed backup lost its tail
+        bool isBackup = filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".bak") == 0;
+        if (!isBackup && checkDataFile(filename + ".bak") == DataFileCheck::Ok) return DataFileCheck::Corrupt;
+        return DataFileCheck::NoChecksum;
+    }
+    if (pos != 0) pos++;
+    string_view footer = text.substr(pos + 7);
+    size_t nl = footer.find('\n');
+    if (nl == string_view::npos) return DataFileCheck::Corrupt; // torn footer
+    footer = footer.substr(0, nl);
+
+    uint32_t crc = 0;
+    unsigned long long len = 0;
+    auto hex = from_chars(footer.data(), footer.data() + footer.size(), crc, 16);
+    string_view rest(hex.ptr, footer.data() + footer.size() - hex.ptr);
+    if (hex.ec != errc() || rest.substr(0, 5) != " len=") return DataFileCheck::Corrupt;
+    rest.remove_prefix(5);
+    if (from_chars(rest.data(), rest.data() + rest.size(), len).ec != errc() || len != pos) return DataFileCheck::Corrupt;
+    return FileUtil::crc32(text.substr(0, pos)) == crc ? DataFileCheck::Ok : DataFileCheck::Corrupt;
+}
+
+vector<string> Persistence::recoverDataFiles()
+{
+    SE_TRACE_SCOPE("Persistence::recoverDataFiles");
+    ensureDataFolderExists();
+    vector<string> notes;
+    for (string name : {"customers.txt", "owners.txt", "restaurants.txt", "orders.txt"}) {
+        if (checkDataFile(name) != DataFileCheck::Corrupt) continue;
+        string path = dataFolder + name;
+        error_code ec;
+        filesystem::rename(path, path + ".corrupt", ec);
+        if (ec) {
+            notes.push_back(name + " failed its checksum and could not be moved aside: " + ec.message());
+            continue;
+        }
+        DataFileCheck backup = checkDataFile(name + ".bak");
+        if ((backup == DataFileCheck::Ok || backup == DataFileCheck::NoChecksum)
+            && FileUtil::replaceDurable(path, FileUtil::readFrom(path + ".bak", 0))) {
+            notes.push_back(name + " failed its checksum: restored the previous version from " + name
+                            + ".bak (changes saved after it are lost; the damaged file is " + name + ".corrupt)");
+        } else {
+            notes.push_back(name + " failed its checksum and has no usable backup; it was moved to " + name + ".corrupt");
+        }
+    }
+    for (const auto &n : notes) cerr << n << "\n";
+    return notes;
+}
+
+// Footer, then an atomic replace that keeps the old file as .bak
+static bool writeTable(const string &filename, string &contents)
+{
+    uint32_t crc = FileUtil::crc32(contents);
+    contents += Persistence::checksumFooter(crc, contents.size());
+    string path = Persistence::dataFolder + filename;
+    if (!FileUtil::replaceDurable(path, contents, true)) {
+        cerr << "Failed to write " << path << "\n";
+        return false;
+    }
+    countWritten(filename, contents.size());
+    return true;
+}
+
+// Single-row appends (saveCustomer, ...) go after the footer, see checkDataFile
+static void appendRow(const string &filename, const string &row)
+{
+    Persistence::ensureDataFolderExists();
+    ofstream ofs(Persistence::dataFolder + filename, ios::app | ios::binary);
+    if (!ofs) return;
+    ofs.write(row.data(), (streamsize)row.size());
+    if (ofs) countWritten(filename, row.size());
+}
+
+// Rows are built with plain appends, so a whole table is one buffer and one write
+static void appendCustomerRow(string &out, const Customer &c, int points)
+{
+    out += to_string(c.id); out += '|'; out += c.name; out += '|'; out += c.email; out += '|';
+    out += c.phone; out += '|'; out += c.password; out += '|'; out += c.isActive ? '1' : '0'; out += '|';
+    out += to_string(points); out += '\n';
+}
+
+static void appendOwnerRow(string &out, const Owner &o)
+{
+    out += to_string(o.id); out += '|'; out += o.name; out += '|'; out += o.email; out += '|';
+    out += o.phone; out += '|'; out += o.password; out += '|'; out += o.isActive ? '1' : '0'; out += '\n';
+}
+
+static void appendRestaurantRow(string &out, const Restaurant &r)
+{
+    out += to_string(r.id); out += '|'; out += r.name; out += '|'; out += r.address.line1; out += '|';
+    out += r.address.city; out += '|'; out += r.address.postalCode; out += '|';
+    out += to_string(r.ownerId); out += '|'; out += to_string(r.menu.size());
+    for (const auto &mi : r.menu)
+    {
+        out += '|'; out += to_string(mi.id); out += ','; out += mi.name.str(); out += ',';
+        out += mi.price.str(); out += ','; out += mi.available ? '1' : '0';
+    }
+    out += '\n';
+}
+
+// ----------------- Customers -----------------
+void Persistence::saveCustomer(const Customer &c, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveCustomer");
+    string row;
+    appendCustomerRow(row, c, c.loyaltyPoints);
+    appendRow(filename, row);
+}
+
+string Persistence::pointsJournalName(const string &filename) { return filename + ".points"; }
+string Persistence::pointsLockName(const string &filename) { return filename + ".points.lock"; }
+
+// Generation from the journal's "#gen=G" first line; 0 for a journal that never was folded
+static long long journalGeneration(string_view journal)
+{
+    long long gen = 0;
+    if (journal.substr(0, 5) == "#gen=") from_chars(journal.data() + 5, journal.data() + journal.size(), gen);
+    return gen;
+}
+
+void Persistence::addLoyaltyPoints(int customerId, int delta, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::addLoyaltyPoints");
+    if (delta == 0) return;
+    ensureDataFolderExists();
+    string journal = dataFolder + pointsJournalName(filename);
+    string record = to_string(customerId) + "|" + to_string(delta) + "\n";
+    FileLock lock(dataFolder + pointsLockName(filename), false);
+    if (!FileUtil::appendDurable(journal, record))
+        cerr << "Failed to append to " << journal << "\n";
+    else
+        countWritten(pointsJournalName(filename), record.size());
+}
+
+void Persistence::addLoyaltyPoints(const vector<pair<int, int>> &deltas, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::addLoyaltyPoints");
+    string records;
+    for (const auto &d : deltas) {
+        if (d.second == 0) continue;
+        records += to_string(d.first) + "|" + to_string(d.second) + "\n";
+    }
+    if (records.empty()) return;
+    ensureDataFolderExists();
+    string journal = dataFolder + pointsJournalName(filename);
+    FileLock lock(dataFolder + pointsLockName(filename), false);
+    if (!FileUtil::appendDurable(journal, records))
+        cerr << "Failed to append to " << journal << "\n";
+    else
+        countWritten(pointsJournalName(filename), records.size());
+}
+
+vector<bool> Persistence::spendLoyaltyPoints(const vector<int> &customerIds, int cost, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::spendLoyaltyPoints");
+    vector<bool> spent(customerIds.size(), false);
+    if (customerIds.empty()) return spent;
+    ensureDataFolderExists();
+    string journal = dataFolder + pointsJournalName(filename);
+    FileLock lock(dataFolder + pointsLockName(filename), true); // no other append or fold until our records are in
+
+    unordered_map<int, int> balance;
+    for (int id : customerIds) balance.emplace(id, 0);
+    for (const auto &c : loadAllCustomers(filename)) {
+        auto it = balance.find(c.id);
+        if (it != balance.end()) it->second = c.loyaltyPoints;
+    }
+    string records;
+    for (size_t i = 0; i < customerIds.size(); ++i) {
+        int &points = balance[customerIds[i]];
+        if (points < cost) continue;
+        points -= cost;
+        spent[i] = true;
+        records += to_string(customerIds[i]) + "|" + to_string(-cost) + "\n";
+    }
+    if (records.empty()) return spent;
+    if (!FileUtil::appendDurable(journal, records)) {
+        cerr << "Failed to append to " << journal << "\n";
+        return vector<bool>(customerIds.size(), false);
+    }
+    countWritten(pointsJournalName(filename), records.size());
+    return spent;
+}
+
+void Persistence::saveAllCustomers(const vector<Customer> &customers, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveAllCustomers");
+    ensureDataFolderExists();
+    string journal = dataFolder + pointsJournalName(filename);
+    FileLock lock(dataFolder + pointsLockName(filename), true); // holds off addLoyaltyPoints while the journal is folded in
+
+    unordered_map<int, int> diskPoints; // snapshot + journal, authoritative for points
+    for (const auto &c : loadAllCustomers(filename)) diskPoints[c.id] = c.loyaltyPoints;
+
+    // The journal as loadAllCustomers just applied it: up to its last complete record
+    string folded = FileUtil::readFrom(journal, 0);
+    size_t end = folded.rfind('\n');
+    size_t foldedBytes = end == string::npos ? 0 : end + 1;
+    long long gen = journalGeneration(folded);
+
+    string out = "#points gen=" + to_string(gen) + " bytes=" + to_string(foldedBytes) + "\n";
+    out.reserve(customers.size() * 64);
+    for (const auto &c : customers)
+    {
+        auto disk = diskPoints.find(c.id);
+        appendCustomerRow(out, c, disk != diskPoints.end() ? disk->second : c.loyaltyPoints);
+    }
+    if (!writeTable(filename, out)) return; // keep the journal if the snapshot did not make it to disk
+    // A crash here is harmless: the snapshot says it holds these bytes of generation gen
+    if (!FileUtil::replaceDurable(journal, "#gen=" + to_string(gen + 1) + "\n"))
+        cerr << "Failed to start a new " << journal << "\n";
+}
+
+vector<Customer> Persistence::loadAllCustomers(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::loadAllCustomers");
+    ensureDataFolderExists();
+    vector<Customer> out;
+    MappedFile file(dataFolder + filename);
+    if (!file.isOpen()) return out;
+
+    string_view text = file.view();
+    long long foldedGen = -1; // journal generation already in the snapshot, -1 if none
+    size_t foldedBytes = 0;
+    while (!text.empty())
+    {
+        string_view line = nextLine(text);
+        if (line.substr(0, 12) == "#points gen=") {
+            string_view f = line.substr(12);
+            auto gen = from_chars(f.data(), f.data() + f.size(), foldedGen);
+            f.remove_prefix(gen.ptr - f.data());
+            if (gen.ec != errc() || f.substr(0, 7) != " bytes=" || from_chars(f.data() + 7, f.data() + f.size(), foldedBytes).ec != errc())
+                foldedGen = -1;
+            continue;
+        }
+        if (line.empty() || line[0] == '#') continue;
+        string_view token = nextField(line, '|');
+        if (token.empty() || token == " ") continue; 
+        Customer c;
+        if (!parseInt(token, c.id)) { cerr << "Skipped bad customer line\n"; continue; }
+        c.name = nextField(line, '|');
+        c.email = nextField(line, '|');
+        c.phone = nextField(line, '|');
+        c.password = nextField(line, '|');
+        c.isActive = (nextField(line, '|') == "1");
+        token = nextField(line, '|');
+        c.loyaltyPoints = 0;
+        if (!token.empty() && !parseInt(token, c.loyaltyPoints)) { cerr << "Skipped bad customer line\n"; continue; }
+        out.push_back(move(c));
+    }
+
+    // Apply the points journal
+    MappedFile journal(dataFolder + pointsJournalName(filename));
+    text = journal.view();
+    // Same generation as the snapshot records: the fold crashed before starting a new
+    // journal, and the first foldedBytes are already counted
+    if (journalGeneration(text) == foldedGen) text.remove_prefix(min(foldedBytes, text.size()));
+    if (text.empty()) return out;
+    unordered_map<int, size_t> byId;
+    for (size_t i = 0; i < out.size(); ++i) byId[out[i].id] = i;
+    size_t end = text.rfind('\n'); // ignore a torn record at the tail
+    text = end == string_view::npos ? string_view() : text.substr(0, end + 1);
+    while (!text.empty())
+    {
+        string_view line = nextLine(text);
+        int id = 0, delta = 0;
+        if (!parseInt(nextField(line, '|'), id) || !parseInt(nextField(line, '|'), delta)) continue;
+        auto found = byId.find(id);
+        if (found != byId.end()) out[found->second].loyaltyPoints += delta;
+    }
+    return out;
+}
+
+// ----------------- Owners -----------------
+void Persistence::saveOwner(const Owner &o, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveOwner");
+    string row;
+    appendOwnerRow(row, o);
+    appendRow(filename, row);
+}
+
+// --- NEW: Save All Owners ---
+void Persistence::saveAllOwners(const vector<Owner> &owners, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveAllOwners");
+    ensureDataFolderExists();
+    string out;
+    out.reserve(owners.size() * 64);
+    for (const auto &o : owners) appendOwnerRow(out, o);
+    writeTable(filename, out);
+}
+
+vector<Owner> Persistence::loadAllOwners(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::loadAllOwners");
+    ensureDataFolderExists();
+    vector<Owner> out;
+    MappedFile file(dataFolder + filename);
+    if (!file.isOpen()) return out;
+
+    string_view text = file.view();
+    while (!text.empty())
+    {
+        string_view line = nextLine(text);
+        if (line.empty() || line[0] == '#') continue;
+        string_view token = nextField(line, '|');
+        if (token.empty()) continue;
+        Owner o;
+        if (!parseInt(token, o.id)) { cerr << "Skipped bad owner line\n"; continue; }
+        o.name = nextField(line, '|');
+        o.email = nextField(line, '|');
+        o.phone = nextField(line, '|');
+        o.password = nextField(line, '|');
+        o.isActive = (nextField(line, '|') == "1");
+        out.push_back(move(o));
+    }
+    return out;
+}
+
+// ----------------- Restaurants -----------------
+void Persistence::saveRestaurant(const Restaurant &r, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveRestaurant");
+    string row;
+    appendRestaurantRow(row, r);
+    appendRow(filename, row);
+}
+
+vector<Restaurant> Persistence::loadAllRestaurants(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::loadAllRestaurants");
+    ensureDataFolderExists();
+    vector<Restaurant> out;
+    MappedFile file(dataFolder + filename);
+    if (!file.isOpen()) return out;
+
+    string_view text = file.view();
+    while (!text.empty())
+    {
+        string_view line = nextLine(text);
+        if (line.empty() || line[0] == '#') continue;
+        string_view token = nextField(line, '|');
+        if (token.empty()) continue;
+        Restaurant r;
+        int menuCount = 0;
+        bool ok = parseInt(token, r.id);
+        r.name = nextField(line, '|');
+        r.address.line1 = nextField(line, '|');
+        r.address.city = nextField(line, '|');
+        r.address.postalCode = nextField(line, '|');
+        ok = ok && parseInt(nextField(line, '|'), r.ownerId);
+        ok = ok && parseInt(nextField(line, '|'), menuCount);
+        for (int i = 0; ok && i < menuCount; ++i)
+        {
+            // id,name,price,available
+            string_view mit = nextField(line, '|');
+            MenuItem mi;
+            ok = parseInt(nextField(mit, ','), mi.id);
+            mi.name = nextField(mit, ',');
+            ok = ok && parseMoney(nextField(mit, ','), mi.price);
+            mi.available = (nextField(mit, ',') == "1");
+            r.menu.push_back(move(mi));
+        }
+        if (!ok) { cerr << "Skipped bad restaurant line\n"; continue; }
+        out.push_back(move(r));
+    }
+    return out;
+}
+
+void Persistence::saveAllRestaurants(const vector<Restaurant> &restaurants, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveAllRestaurants");
+    ensureDataFolderExists();
+    string out;
+    out.reserve(restaurants.size() * 256);
+    for (const auto &r : restaurants) appendRestaurantRow(out, r);
+    writeTable(filename, out);
+}
+
+// ----------------- Orders -----------------
+size_t Persistence::orderLogCompactBytes = 1 << 20; // 1 MiB of events
+
+string Persistence::orderLogName(const string &filename) { return filename + ".log"; }
+string Persistence::orderLockName(const string &filename) { return filename + ".lock"; }
+
+static void appendOrderRow(string &out, const Order &o)
+{
+    out += to_string(o.id); out += '|'; out += to_string(o.customerId); out += '|';
+    out += to_string(o.restaurantId); out += '|'; out += toString(o.status); out += '|';
+    out += o.total.str(); out += '|'; out += to_string(o.items.size());
+    for (const auto &it : o.items)
+    {
+        out += '|'; out += to_string(it.itemSnapshot.id); out += ','; out += it.itemSnapshot.name.str();
+        out += ','; out += to_string(it.qty); out += ','; out += it.unitPrice.str();
+    }
+    if (o.version != 0) { out += '|'; out += to_string(o.version); } // optional, after the items
+}
+
+static string formatOrderLine(const Order &o)
+{
+    string line;
+    appendOrderRow(line, o);
+    return line;
+}
+
+string Persistence::formatOrder(const Order &o) { return formatOrderLine(o); }
+
+// false on malformed input, callers skip the line
+static bool parseOrderLine(string_view line, Order &o)
+{
+    string_view token = nextField(line, '|');
+    if (!parseInt(token, o.id)) return false;
+    int itemCount = 0;
+    bool ok = parseInt(nextField(line, '|'), o.customerId);
+    ok = ok && parseInt(nextField(line, '|'), o.restaurantId);
+    ok = ok && parseOrderStatus(nextField(line, '|'), o.status);
+    ok = ok && parseMoney(nextField(line, '|'), o.total);
+    ok = ok && parseInt(nextField(line, '|'), itemCount);
+    if (ok && itemCount > 0) o.items.reserve(itemCount);
+    for (int i = 0; ok && i < itemCount; ++i)
+    {
+        // id,name,qty,unitPrice
+        string_view mit = nextField(line, '|');
+        OrderItem it;
+        ok = parseInt(nextField(mit, ','), it.itemSnapshot.id);
+        it.itemSnapshot.name = nextField(mit, ',');
+        ok = ok && parseInt(nextField(mit, ','), it.qty);
+        ok = ok && parseMoney(nextField(mit, ','), it.unitPrice);
+        o.items.push_back(move(it));
+    }
+    if (ok && !line.empty()) ok = parseInt(nextField(line, '|'), o.version);
+    return ok;
+}
+
+// Log records, one per line:
+//   P|<order line>             order placed (same layout as orders.txt)
+//   S|<id>|<restaurantId>|<status>|<version>   status change producing that version
+// Replay is idempotent: a P record for a key already in the snapshot replaces it,
+// and an S record only applies when its version is one past the order's.
+// Compaction writes the new snapshot to a temp file, fsyncs it and renames it over
+// orders.txt (writeTable), and only then deletes the log. A crash before the rename
+// leaves the old snapshot and the whole log; a crash after it leaves the new
+// snapshot and a log whose replay changes nothing. Either way no order is lost.
+//
+// Terminals sharing a data folder: appends hold a shared flock on orders.txt.lock
+// and compaction an exclusive one, so no record lands between compaction reading
+// the log and deleting it. O_APPEND keeps concurrent appends whole.
+// records: one or more complete lines, written with a single append and fsync
+static bool appendOrderEvents(const string &records, const string &filename)
+{
+    Persistence::ensureDataFolderExists();
+    string logPath = Persistence::dataFolder + Persistence::orderLogName(filename);
+    FileLock table(Persistence::dataFolder + Persistence::orderLockName(filename), false);
+    if (!FileUtil::appendDurable(logPath, records)) {
+        cerr << "Failed to append to " << logPath << "\n";
+        return false;
+    }
+    SE_TRACE_COUNTER("order log bytes", records.size());
+    countWritten(Persistence::orderLogName(filename), records.size());
+    return true;
+}
+
+void Persistence::compactOrdersIfDue(const string &filename)
+{
+    if (FileUtil::fileSize(dataFolder + orderLogName(filename)) >= orderLogCompactBytes)
+        compactOrders(filename);
+}
+
+bool Persistence::saveOrder(const Order &o, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveOrder");
+    if (!appendOrderEvents("P|" + formatOrderLine(o) + "\n", filename)) return false;
+    compactOrdersIfDue(filename);
+    return true;
+}
+
+bool Persistence::saveOrders(const vector<Order> &orders, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveOrders");
+    if (orders.empty()) return true;
+    string records;
+    for (const auto &o : orders) {
+        records += "P|";
+        records += formatOrderLine(o);
+        records += '\n';
+    }
+    if (!appendOrderEvents(records, filename)) return false;
+    compactOrdersIfDue(filename);
+    return true;
+}
+
+bool Persistence::appendOrderStatus(const Order &o, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::appendOrderStatus");
+    if (!appendOrderEvents("S|" + to_string(o.id) + "|" + to_string(o.restaurantId) + "|" + toString(o.status)
+                           + "|" + to_string(o.version) + "\n", filename))
+        return false;
+    countStatusChange(o.status, o.restaurantId);
+    return true;
+}
+
+bool Persistence::saveOrderStatus(const Order &o, const string &filename)
+{
+    if (!appendOrderStatus(o, filename)) return false;
+    compactOrdersIfDue(filename);
+    return true;
+}
+
+// Caller holds the exclusive table lock
+static void writeOrderTable(const vector<Order> &orders, const string &filename)
+{
+    string out;
+    out.reserve(orders.size() * 64);
+    for (const auto &o : orders)
+    {
+        appendOrderRow(out, o);
+        out += '\n';
+    }
+    if (!writeTable(filename, out)) return; // keep the log if the snapshot did not make it to disk
+    // Snapshot now holds every event, start a fresh log
+    error_code ec;
+    filesystem::remove(Persistence::dataFolder + Persistence::orderLogName(filename), ec);
+}
+
+void Persistence::saveAllOrders(const vector<Order> &orders, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveAllOrders");
+    ensureDataFolderExists();
+    FileLock table(dataFolder + orderLockName(filename), true);
+    writeOrderTable(orders, filename);
+}
+
+void Persistence::restoreOrders(vector<Order> orders, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::restoreOrders");
+    ensureDataFolderExists();
+    FileLock table(dataFolder + orderLockName(filename), true);
+    unordered_map<uint64_t, size_t> byKey;
+    byKey.reserve(orders.size());
+    for (size_t i = 0; i < orders.size(); ++i) byKey[orders[i].key()] = i;
+    applyOrderLog(FileUtil::readFrom(dataFolder + orderLogName(filename), 0), orders, byKey);
+    writeOrderTable(orders, filename);
+}
+
+void Persistence::compactOrders(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::compactOrders");
+    ensureDataFolderExists();
+    FileLock table(dataFolder + orderLockName(filename), true);
+    // Folding the log into a damaged snapshot would drop the rows that fail to parse,
+    // and the log with them: leave both for recoverDataFiles
+    if (checkDataFile(filename) == DataFileCheck::Corrupt) {
+        cerr << "Not compacting " << dataFolder << filename << ": it fails its checksum\n";
+        return;
+    }
+    vector<Order> orders = loadAllOrders(filename);
+    writeOrderTable(orders, filename);
+
+    string binName = filesystem::path(filename).replace_extension(".bin").string();
+    if (filesystem::exists(dataFolder + binName)) saveOrdersBinary(orders, binName);
+}
+
+bool Persistence::saveOrdersBinary(const vector<Order> &orders, const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::saveOrdersBinary");
+    ensureDataFolderExists();
+    if (!OrderSnapshot::write(dataFolder + filename, orders)) return false;
+    countWritten(filename, FileUtil::fileSize(dataFolder + filename));
+    return true;
+}
+
+vector<Order> Persistence::loadOrdersBinary(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::loadOrdersBinary");
+    ensureDataFolderExists();
+    return OrderSnapshot::read(dataFolder + filename);
+}
+
+vector<Order> Persistence::loadOrderSnapshot(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::loadOrderSnapshot");
+    ensureDataFolderExists();
+    vector<Order> out;
+    MappedFile file(dataFolder + filename);
+    string_view text = file.view();
+    out.reserve(count(text.begin(), text.end(), '\n') + 1);
+    while (!text.empty())
+    {
+        string_view line = nextLine(text);
+        if (line.empty() || line[0] == '#') continue;
+        Order o;
+        if (!parseOrderLine(line, o)) { cerr << "Skipped bad order line\n"; continue; }
+        out.push_back(move(o));
+    }
+    SE_TRACE_COUNTER("orders parsed", out.size());
+    return out;
+}
+
+size_t Persistence::applyOrderLog(string_view chunk, vector<Order> &orders, unordered_map<uint64_t, size_t> &byKey)
+{
+    SE_TRACE_SCOPE("Persistence::applyOrderLog");
+    size_t end = chunk.rfind('\n'); // ignore a torn record at the tail
+    if (end == string_view::npos) return 0;
+    string_view log = chunk.substr(0, end + 1);
+
+    while (!log.empty())
+    {
+        string_view line = nextLine(log);
+        if (line.size() < 2 || line[1] != '|') continue;
+        char kind = line[0];
+        line.remove_prefix(2);
+        if (kind == 'P') {
+            Order o;
+            if (!parseOrderLine(line, o)) { cerr << "Skipped bad order log record\n"; continue; }
+            auto found = byKey.find(o.key());
+            if (found != byKey.end()) orders[found->second] = move(o);
+            else { byKey[o.key()] = orders.size(); orders.push_back(move(o)); }
+        } else if (kind == 'S') {
+            int id = 0, restaurantId = 0, version = -1;
+            OrderStatus status;
+            if (!parseInt(nextField(line, '|'), id) || !parseInt(nextField(line, '|'), restaurantId)
+                || !parseOrderStatus(nextField(line, '|'), status)
+                || (!line.empty() && !parseInt(nextField(line, '|'), version))) {
+                cerr << "Skipped bad order log record\n";
+                continue;
+            }
+            auto found = byKey.find(Order::makeKey(id, restaurantId));
+            if (found == byKey.end()) continue;
+            Order &o = orders[found->second];
+            if (version < 0) version = o.version + 1; // record from before versions existed
+            // Anything else lost the race to a change already applied (or was replayed twice)
+            if (version == o.version + 1) {
+                o.status = status;
+                o.version = version;
+            }
+        }
+    }
+    return end + 1;
+}
+
+vector<Order> Persistence::loadAllOrders(const string &filename)
+{
+    SE_TRACE_SCOPE("Persistence::loadAllOrders");
+    vector<Order> out = loadOrderSnapshot(filename);
+
+    // Replay the event log on top of the snapshot
+    MappedFile logFile(dataFolder + orderLogName(filename));
+    if (logFile.view().empty()) return out;
+
+    unordered_map<uint64_t, size_t> byKey; // order key -> index in out
+    byKey.reserve(out.size());
+    for (size_t i = 0; i < out.size(); ++i) byKey[out[i].key()] = i;
+    applyOrderLog(logFile.view(), out, byKey);
+    return out;
+}
@@ -0,0 +1,87 @@
+#include "PersistenceService.hpp"
+#include "Trace.hpp"
+using namespace std;
+
+PersistenceService::PersistenceService() : worker(&PersistenceService::run, this) {}
+
+PersistenceService::~PersistenceService()
+{
+    {
+        lock_guard<mutex> lk(m);
+        stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+future<void> PersistenceService::submit(const string &key, function<void()> job)
+{
+    promise<void> p;
+    future<void> f = p.get_future();
+    {
+        lock_guard<mutex> lk(m);
+        Task *same = nullptr;
+        if (!key.empty()) {
+            for (auto &t : queue)
+                if (t.key == key) same = &t;
+        }
+        if (same) {
+            same->job = move(job);
+            same->waiters.push_back(move(p));
+        } else {
+            Task t;
+            t.key = key;
+            t.job = move(job);
+            t.waiters.push_back(move(p));
+            queue.push_back(move(t));
+        }
+    }
+    wake.notify_one();
+    return f;
+}
+
+void PersistenceService::flush()
+{
+    unique_lock<mutex> lk(m);
+    drained.wait(lk, [&] { return queue.empty() && !running; });
+}
+
+bool PersistenceService::idle()
+{
+    lock_guard<mutex> lk(m);
+    return queue.empty() && !running;
+}
+
+void PersistenceService::run()
+{
+#if SUSTIEATS_TRACE
+    Trace::nameThread("persistence");
+#endif
+    unique_lock<mutex> lk(m);
+    for (;;) {
+        wake.wait(lk, [&] { return stopping || !queue.empty(); });
+        if (queue.empty()) break; // stopping, and everything has been written
+
+        Task t = move(queue.front());
+        queue.pop_front();
+        running = true;
+        lk.unlock();
+
+        exception_ptr err;
+        try {
+            SE_TRACE_SCOPE("PersistenceService job");
+            t.job();
+        } catch (...) {
+            err = current_exception();
+        }
+        for (auto &w : t.waiters) {
+            if (err) w.set_exception(err);
+            else w.set_value();
+        }
+
+        lk.lock();
+        running = false;
+        if (queue.empty()) drained.notify_all();
+    }
+    drained.notify_all();
+}
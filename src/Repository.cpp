@@ -0,0 +1,74 @@
+#include "Repository.hpp"
+#include <algorithm>
+using namespace std;
+
+void Repository::setCustomers(vector<Customer> rows)
+{
+    for (auto &c : rows) {
+        Customer *old = findCustomer(c.id);
+        if (old && old->cart) c.cart = move(old->cart);
+    }
+    customerRows = move(rows);
+    customerById.clear();
+    customerById.reserve(customerRows.size());
+    for (size_t i = 0; i < customerRows.size(); ++i) customerById[customerRows[i].id] = i;
+}
+
+void Repository::setOwners(vector<Owner> rows)
+{
+    ownerRows = move(rows);
+    ownerById.clear();
+    ownerById.reserve(ownerRows.size());
+    for (size_t i = 0; i < ownerRows.size(); ++i) ownerById[ownerRows[i].id] = i;
+}
+
+void Repository::setRestaurants(vector<Restaurant> rows)
+{
+    restaurantRows = move(rows);
+    restaurantById.clear();
+    restaurantsByOwner.clear();
+    restaurantById.reserve(restaurantRows.size());
+    for (size_t i = 0; i < restaurantRows.size(); ++i) {
+        restaurantById[restaurantRows[i].id] = i;
+        restaurantsByOwner[restaurantRows[i].ownerId].push_back(i);
+    }
+}
+
+Customer *Repository::findCustomer(int id)
+{
+    auto it = customerById.find(id);
+    return it == customerById.end() ? nullptr : &customerRows[it->second];
+}
+
+Owner *Repository::findOwner(int id)
+{
+    auto it = ownerById.find(id);
+    return it == ownerById.end() ? nullptr : &ownerRows[it->second];
+}
+
+Restaurant *Repository::findRestaurant(int id)
+{
+    auto it = restaurantById.find(id);
+    return it == restaurantById.end() ? nullptr : &restaurantRows[it->second];
+}
+
+static const vector<size_t> NO_RESTAURANTS;
+
+const vector<size_t> &Repository::restaurantsOf(int ownerId) const
+{
+    auto it = restaurantsByOwner.find(ownerId);
+    return it == restaurantsByOwner.end() ? NO_RESTAURANTS : it->second;
+}
+
+vector<size_t> Repository::ordersForOwner(int ownerId) const
+{
+    vector<size_t> out;
+    const auto &mine = restaurantsOf(ownerId);
+    for (size_t ri : mine) {
+        const auto &ids = orderStore.ordersForRestaurant(restaurantRows[ri].id);
+        out.insert(out.end(), ids.begin(), ids.end());
+    }
+    // Each list is already in file order; only owners with several restaurants need a merge
+    if (mine.size() > 1) sort(out.begin(), out.end());
+    return out;
+}
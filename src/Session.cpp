@@ -0,0 +1,45 @@
+#include "Session.hpp"
+#include "Persistence.hpp"
+using namespace std;
+
+LoginResult Session::loginCustomer(Repository &repo, int id, const string &password)
+{
+    Customer *c = repo.findCustomer(id);
+    if (!c || !c->login(password)) return LoginResult::BadCredentials;
+    if (!c->isActive) return LoginResult::Disabled;
+    *this = Session();
+    role = Role::CustomerRole;
+    userId = id;
+    return LoginResult::Ok;
+}
+
+LoginResult Session::loginOwner(Repository &repo, int id, const string &password)
+{
+    Owner *o = repo.findOwner(id);
+    if (!o || !o->login(password)) return LoginResult::BadCredentials;
+    if (!o->isActive) return LoginResult::Disabled;
+    *this = Session();
+    role = Role::OwnerRole;
+    ownerId = id;
+    return LoginResult::Ok;
+}
+
+bool Session::loginAdmin(int id, const string &password)
+{
+    if (!Persistence::verifyAdmin(id, password)) return false;
+    *this = Session();
+    role = Role::AdminRole;
+    userId = id;
+    return true;
+}
+
+Customer *Session::customer(Repository &repo) const
+{
+    return role == Role::CustomerRole ? repo.findCustomer(userId) : nullptr;
+}
+
+void Session::logout(Repository &repo)
+{
+    if (Customer *c = customer(repo)) c->cart.reset();
+    *this = Session();
+}
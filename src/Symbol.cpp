@@ -0,0 +1,72 @@
+#include "Symbol.hpp"
+#include <deque>
+#include <unordered_map>
+#include <shared_mutex>
+#include <mutex>
+using namespace std;
+
+namespace
+{
+// deque: push_back never moves the strings, so the string_view keys and the
+// references handed out by str() stay valid as the table grows
+struct SymbolTable
+{
+    shared_mutex mtx;
+    deque<string> names{string()};
+    unordered_map<string_view, uint32_t> ids{{string_view(names[0]), 0}};
+};
+
+SymbolTable &table()
+{
+    static SymbolTable t; // constructed on first use, so static initializers may intern too
+    return t;
+}
+}
+
+uint32_t Symbol::intern(string_view s)
+{
+    if (s.empty()) return 0;
+    // Loaders intern the same few names over and over; each thread remembers the
+    // ones it has seen so the common case takes no lock (keys point into the table)
+    thread_local unordered_map<string_view, uint32_t> seen;
+    auto hit = seen.find(s);
+    if (hit != seen.end()) return hit->second;
+
+    SymbolTable &t = table();
+    uint32_t id;
+    {
+        shared_lock<shared_mutex> lock(t.mtx);
+        auto it = t.ids.find(s);
+        if (it != t.ids.end()) {
+            seen.emplace(it->first, it->second);
+            return it->second;
+        }
+    }
+    {
+        unique_lock<shared_mutex> lock(t.mtx);
+        auto it = t.ids.find(s); // another thread may have added it in between
+        if (it != t.ids.end()) {
+            id = it->second;
+        } else {
+            id = (uint32_t)t.names.size();
+            t.names.emplace_back(s);
+            t.ids.emplace(string_view(t.names.back()), id);
+        }
+        seen.emplace(string_view(t.names[id]), id);
+    }
+    return id;
+}
+
+const string &Symbol::str() const
+{
+    SymbolTable &t = table();
+    shared_lock<shared_mutex> lock(t.mtx);
+    return t.names[sym];
+}
+
+size_t Symbol::tableSize()
+{
+    SymbolTable &t = table();
+    shared_lock<shared_mutex> lock(t.mtx);
+    return t.names.size();
+}
@@ -0,0 +1,202 @@
+#include "Trace.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <map>
+#include <string_view>
+#include <algorithm>
+using namespace std;
+
+namespace
+{
+const size_t MAX_EVENTS_PER_THREAD = 1 << 20; // about 32 MiB; later events are counted as dropped
+
+struct TraceEvent
+{
+    const char *name;
+    uint64_t ts;
+    uint64_t dur;
+    int64_t value;
+    char phase; // 'X' complete scope, 'C' counter
+};
+
+struct ThreadBuffer
+{
+    mutex mtx;
+    int tid = 0;
+    string threadName;
+    vector<TraceEvent> events;
+    uint64_t dropped = 0;
+    unordered_map<const char *, TraceStat> stats;
+};
+
+struct TraceRegistry
+{
+    mutex mtx;
+    vector<shared_ptr<ThreadBuffer>> buffers; // kept after their thread exits, for the export
+    atomic<bool> capturing{false};
+    chrono::steady_clock::time_point epoch = chrono::steady_clock::now();
+};
+
+TraceRegistry &registry()
+{
+    static TraceRegistry r;
+    return r;
+}
+
+ThreadBuffer &localBuffer()
+{
+    thread_local shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = make_shared<ThreadBuffer>();
+        TraceRegistry &r = registry();
+        lock_guard<mutex> lock(r.mtx);
+        buffer->tid = (int)r.buffers.size() + 1;
+        r.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void pushEvent(ThreadBuffer &b, const TraceEvent &e)
+{
+    if (b.events.size() < MAX_EVENTS_PER_THREAD) b.events.push_back(e);
+    else b.dropped++;
+}
+
+void writeJsonString(ostream &os, string_view s)
+{
+    os << '"';
+    for (char c : s) {
+        if (c == '"' || c == '\\') os << '\\' << c;
+        else if ((unsigned char)c < 0x20) os << ' ';
+        else os << c;
+    }
+    os << '"';
+}
+}
+
+uint64_t Trace::nowNs()
+{
+    return (uint64_t)chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - registry().epoch).count();
+}
+
+void Trace::scopeEnded(const char *name, uint64_t startNs, uint64_t endNs)
+{
+    ThreadBuffer &b = localBuffer();
+    uint64_t dur = endNs - startNs;
+    lock_guard<mutex> lock(b.mtx);
+    TraceStat &s = b.stats[name];
+    s.calls++;
+    s.totalNs += dur;
+    s.maxNs = max(s.maxNs, dur);
+    if (registry().capturing.load(memory_order_relaxed)) pushEvent(b, TraceEvent{name, startNs, dur, 0, 'X'});
+}
+
+void Trace::counter(const char *name, int64_t value)
+{
+    ThreadBuffer &b = localBuffer();
+    uint64_t ts = nowNs();
+    lock_guard<mutex> lock(b.mtx);
+    TraceStat &s = b.stats[name];
+    s.calls++;
+    s.value += value;
+    if (registry().capturing.load(memory_order_relaxed)) pushEvent(b, TraceEvent{name, ts, 0, value, 'C'});
+}
+
+void Trace::nameThread(const string &name)
+{
+    ThreadBuffer &b = localBuffer();
+    lock_guard<mutex> lock(b.mtx);
+    b.threadName = name;
+}
+
+void Trace::startCapture()
+{
+    TraceRegistry &r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    for (auto &b : r.buffers) {
+        lock_guard<mutex> bl(b->mtx);
+        b->events.clear();
+        b->dropped = 0;
+    }
+    r.capturing.store(true);
+}
+
+void Trace::stopCapture() { registry().capturing.store(false); }
+
+bool Trace::capturing() { return registry().capturing.load(memory_order_relaxed); }
+
+bool Trace::writeChromeTrace(const string &path)
+{
+    ofstream ofs(path, ios::trunc);
+    if (!ofs) { cerr << "Cannot write trace " << path << "\n"; return false; }
+
+    TraceRegistry &r = registry();
+    lock_guard<mutex> lock(r.mtx);
+    uint64_t dropped = 0;
+    bool first = true;
+    char num[64];
+    ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (auto &b : r.buffers) {
+        lock_guard<mutex> bl(b->mtx);
+        dropped += b->dropped;
+        if (!b->threadName.empty()) {
+            ofs << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << b->tid << ",\"args\":{\"name\":";
+            writeJsonString(ofs, b->threadName);
+            ofs << "}}";
+            first = false;
+        }
+        for (const TraceEvent &e : b->events) {
+            ofs << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(ofs, e.name);
+            snprintf(num, sizeof(num), "%.3f", e.ts / 1000.0); // microseconds
+            ofs << ",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << b->tid << ",\"ts\":" << num;
+            if (e.phase == 'X') {
+                snprintf(num, sizeof(num), "%.3f", e.dur / 1000.0);
+                ofs << ",\"dur\":" << num << "}";
+            } else {
+                ofs << ",\"args\":{\"value\":" << e.value << "}}";
+            }
+            first = false;
+        }
+    }
+    ofs << "\n]}\n";
+    if (dropped) cerr << "Trace buffer full: " << dropped << " events dropped\n";
+    ofs.flush();
+    if (!ofs) { cerr << "Cannot write trace " << path << "\n"; return false; }
+    return true;
+}
+
+vector<TraceStat> Trace::takeStats()
+{
+    map<string_view, TraceStat> merged;
+    TraceRegistry &r = registry();
+    {
+        lock_guard<mutex> lock(r.mtx);
+        for (auto &b : r.buffers) {
+            lock_guard<mutex> bl(b->mtx);
+            for (auto &entry : b->stats) {
+                TraceStat &m = merged[entry.first];
+                const TraceStat &s = entry.second;
+                m.calls += s.calls;
+                m.totalNs += s.totalNs;
+                m.maxNs = max(m.maxNs, s.maxNs);
+                m.value += s.value;
+            }
+            b->stats.clear();
+        }
+    }
+    vector<TraceStat> out;
+    out.reserve(merged.size());
+    for (auto &entry : merged) {
+        out.push_back(entry.second);
+        out.back().name = string(entry.first);
+    }
+    sort(out.begin(), out.end(), [](const TraceStat &a, const TraceStat &b) { return a.totalNs > b.totalNs; });
+    return out;
+}
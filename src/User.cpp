@@ -1 +1 @@
-#include "User.hpp"
+#include "User.hpp"
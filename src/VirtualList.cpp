@@ -0,0 +1,12 @@
+#include "VirtualList.hpp"
+#include <algorithm>
+using namespace std;
+
+pair<size_t, size_t> VirtualList::visible(float y0, float y1) const
+{
+    if (size() == 0 || y1 <= y0) return {0, 0};
+    // first row whose bottom is below y0, then the first row starting at or after y1
+    size_t first = upper_bound(offsets.begin() + 1, offsets.end(), y0) - (offsets.begin() + 1);
+    size_t last = lower_bound(offsets.begin() + first, offsets.end() - 1, y1) - offsets.begin();
+    return {first, max(first, last)};
+}
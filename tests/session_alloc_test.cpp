@@ -0,0 +1,83 @@
+// Logins and session lookups must not copy customers: the Session keeps the
+// customer id and finds the Repository row again (see Session.hpp). A
+// counting operator new checks that a login allocates nothing, and that a
+// reload moves each cart to the new row instead of deep-copying it.
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+#include "Session.hpp"
+
+static std::atomic<long> allocations{0};
+
+void *operator new(std::size_t n) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+
+static const int CUSTOMERS = 1000;
+static const int LOGINS = 10000;
+
+static std::vector<Customer> makeCustomers(bool withCarts) {
+    MenuItem item;
+    item.id = 1;
+    item.price = Money::fromRupees(120);
+    std::vector<Customer> rows(CUSTOMERS);
+    for (int i = 0; i < CUSTOMERS; ++i) {
+        rows[i].id = i + 1;
+        rows[i].name = "Customer " + std::to_string(i + 1);
+        rows[i].password = "pw" + std::to_string(i + 1);
+        if (withCarts) rows[i].addToCart(item, 1, 1, Symbol());
+    }
+    return rows;
+}
+
+// The calls main.cpp makes on login, then once per frame
+static bool loginAndLookup(Repository &repo, int id, const std::string &pw) {
+    Session session;
+    if (session.loginCustomer(repo, id, pw) != LoginResult::Ok) return false;
+    Customer *c = session.customer(repo);
+    return c == repo.findCustomer(id) && c->cart && !c->cart->empty();
+}
+
+int main() {
+    Repository repo;
+    repo.setCustomers(makeCustomers(true));
+    std::vector<std::string> passwords;
+    for (int i = 0; i < CUSTOMERS; ++i) passwords.push_back("pw" + std::to_string(i + 1));
+    if (!loginAndLookup(repo, 1, passwords[0])) { std::cerr << "warm-up login failed\n"; return 1; }
+
+    long before = allocations.load();
+    for (int i = 0; i < LOGINS; ++i) {
+        int id = i % CUSTOMERS + 1;
+        if (!loginAndLookup(repo, id, passwords[id - 1])) { std::cerr << "login " << id << " failed\n"; return 1; }
+    }
+    long perLogins = allocations.load() - before;
+    if (perLogins != 0) {
+        std::cerr << LOGINS << " logins made " << perLogins << " allocations, expected 0\n";
+        return 1;
+    }
+
+    // A reload (another terminal wrote customers.txt) keeps the same Cart objects
+    const Cart *cart = repo.findCustomer(500)->cart.get();
+    repo.setCustomers(makeCustomers(false));
+    if (repo.findCustomer(500)->cart.get() != cart) {
+        std::cerr << "setCustomers copied the cart instead of moving it\n";
+        return 1;
+    }
+    // A refused login leaves the session a guest
+    Session session;
+    repo.findCustomer(2)->isActive = false;
+    if (session.loginCustomer(repo, 1, "wrong") != LoginResult::BadCredentials
+        || session.loginCustomer(repo, 2, passwords[1]) != LoginResult::Disabled || session.customer(repo)) {
+        std::cerr << "a refused login was let in\n";
+        return 1;
+    }
+    std::cout << LOGINS << " logins, 0 allocations; carts moved on reload\n";
+    return 0;
+}
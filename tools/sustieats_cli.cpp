@@ -0,0 +1,261 @@
+// Headless SustiEats driver: runs checkout and order processing against a
+// data folder without opening a window or loading audio.
+//
+//   sustieats_cli [options] <command> [args]
+//   sustieats_cli [options] serve   (reads commands from stdin, one per line)
+//
+// Options:
+//   --data DIR           data folder (default data/)
+//   --trace FILE         record the SE_TRACE_* scopes of the run and write them as a Chrome trace
+//   --metrics FILE       write the operational metrics (Prometheus text format) when done
+//   --metrics-port N     serve them on http://127.0.0.1:N/metrics while running (useful with serve)
+//
+// Commands:
+//   orders [restaurantId]                      list orders
+//   checkout <customerId> <rest:menu:qty>... [--discount]
+//   dispatch <orderId> <restaurantId>
+//   cancel <orderId> <restaurantId>
+//   status <orderId> <restaurantId> <Accepted|Preparing|Dispatched|Delivered|Cancelled|Refunded>
+//   batch <file|->                             batch checkout, one cart per line:
+//                                              <customerId> <rest:menu:qty>... [--discount]
+//   compact                                    fold orders.txt.log into orders.txt
+//   metrics                                    print the operational metrics
+//   verify                                     check the table checksums, restore damaged tables from .bak
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include "Customer.hpp"
+#include "Restaurant.hpp"
+#include "Order.hpp"
+#include "OrderStore.hpp"
+#include "Persistence.hpp"
+#include "LoyaltyManager.hpp"
+#include "Trace.hpp"
+#include "Metrics.hpp"
+#include "MetricsServer.hpp"
+
+static void printUsage() {
+    std::cerr << "usage: sustieats_cli [--data DIR] [--trace FILE] [--metrics FILE] [--metrics-port N]\n"
+                 "                    <orders|checkout|batch|dispatch|cancel|status|compact|metrics|verify|serve> [args]\n";
+}
+
+static int cmdOrders(const std::vector<std::string> &args) {
+    int restFilter = -1;
+    if (!args.empty()) restFilter = std::stoi(args[0]);
+    for (const auto &o : Persistence::loadAllOrders()) {
+        if (restFilter != -1 && o.restaurantId != restFilter) continue;
+        std::cout << o.id << "\tcustomer=" << o.customerId << "\trestaurant=" << o.restaurantId
+                  << "\t" << toString(o.status) << "\t" << o.total << "\n";
+    }
+    return 0;
+}
+
+// Adds args[1..] (rest:menu:qty, or --discount) to the customer's cart
+static bool fillCart(Customer &cust, const std::vector<std::string> &args, const std::vector<Restaurant> &restaurants, bool &useDiscount) {
+    for (size_t i = 1; i < args.size(); ++i) {
+        if (args[i] == "--discount") { useDiscount = true; continue; }
+        // rest:menu:qty
+        std::istringstream iss(args[i]);
+        std::string field;
+        int restId = 0, menuId = 0, qty = 1;
+        std::getline(iss, field, ':'); restId = std::stoi(field);
+        std::getline(iss, field, ':'); menuId = std::stoi(field);
+        if (std::getline(iss, field, ':')) qty = std::stoi(field);
+
+        const Restaurant *rest = nullptr;
+        for (const auto &r : restaurants) if (r.id == restId) { rest = &r; break; }
+        const MenuItem *item = nullptr;
+        if (rest) for (const auto &mi : rest->menu) if (mi.id == menuId) { item = &mi; break; }
+        if (!item) { std::cerr << "No menu item " << menuId << " at restaurant " << restId << "\n"; return false; }
+        cust.addToCart(*item, qty, rest->id, rest->name);
+    }
+    return true;
+}
+
+static int cmdCheckout(const std::vector<std::string> &args) {
+    if (args.size() < 2) { printUsage(); return 2; }
+    int custId = std::stoi(args[0]);
+
+    auto customers = Persistence::loadAllCustomers();
+    Customer *cust = nullptr;
+    for (auto &c : customers) if (c.id == custId) { cust = &c; break; }
+    if (!cust) { std::cerr << "No customer " << custId << "\n"; return 1; }
+    if (!cust->isActive) { std::cerr << "Customer " << custId << " is disabled\n"; return 1; }
+
+    auto restaurants = Persistence::loadAllRestaurants();
+    bool useDiscount = false;
+    if (!fillCart(*cust, args, restaurants, useDiscount)) return 1;
+
+    std::vector<Order> orders = cust->checkout();
+    if (orders.empty()) { std::cerr << "Cart empty\n"; return 1; }
+    if (!LoyaltyManager::processCheckout(*cust, orders, useDiscount)) { std::cerr << "Checkout could not be saved\n"; return 1; }
+
+    for (const auto &o : orders)
+        std::cout << "placed " << o.id << "\trestaurant=" << o.restaurantId << "\t" << o.total << "\n";
+    std::cout << "points " << cust->loyaltyPoints << "\n";
+    return 0;
+}
+
+// Lines for the same customer go into one cart
+static int cmdBatch(const std::vector<std::string> &args) {
+    if (args.empty()) { printUsage(); return 2; }
+    std::ifstream file;
+    if (args[0] != "-") {
+        file.open(args[0]);
+        if (!file) { std::cerr << "Cannot open " << args[0] << "\n"; return 1; }
+    }
+    std::istream &in = args[0] == "-" ? std::cin : file;
+
+    auto customers = Persistence::loadAllCustomers();
+    std::unordered_map<int, size_t> byId;
+    for (size_t i = 0; i < customers.size(); ++i) byId[customers[i].id] = i;
+    auto restaurants = Persistence::loadAllRestaurants();
+
+    std::vector<BatchCart> carts;
+    std::unordered_map<int, size_t> cartOf; // customer id -> index in carts
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        lineNo++;
+        std::istringstream iss(line);
+        std::vector<std::string> fields;
+        std::string f;
+        while (iss >> f) fields.push_back(f);
+        if (fields.empty() || fields[0][0] == '#') continue;
+
+        auto it = byId.find(std::stoi(fields[0]));
+        if (it == byId.end() || !customers[it->second].isActive) {
+            std::cerr << "line " << lineNo << ": no active customer " << fields[0] << ", skipped\n";
+            continue;
+        }
+        Customer &cust = customers[it->second];
+        // Parse into a scratch cart first so a bad line adds nothing
+        Customer scratch;
+        bool useDiscount = false;
+        if (!fillCart(scratch, fields, restaurants, useDiscount)) { std::cerr << "line " << lineNo << " skipped\n"; continue; }
+        if (scratch.cart)
+            for (const auto &ci : scratch.cart->items()) cust.addToCart(ci.item, ci.qty, ci.restaurantId, ci.restaurantName);
+        auto slot = cartOf.emplace(cust.id, carts.size());
+        if (slot.second) carts.push_back(BatchCart{&cust, useDiscount});
+        else carts[slot.first->second].useDiscount |= useDiscount;
+    }
+
+    auto placed = LoyaltyManager::processBatchCheckout(carts);
+    if (placed.empty() && !carts.empty()) { std::cerr << "Batch could not be saved\n"; return 1; }
+    std::cout << "placed " << placed.size() << " orders for " << carts.size() << " carts\n";
+    return 0;
+}
+
+static int cmdStatus(const std::vector<std::string> &args, OrderStatus target) {
+    if (args.size() < 2) { printUsage(); return 2; }
+    int orderId = std::stoi(args[0]);
+    int restId = std::stoi(args[1]);
+    OrderStore store;
+    Order *o = store.find(orderId, restId);
+    if (!o) { std::cerr << "No order " << orderId << " for restaurant " << restId << "\n"; return 1; }
+    switch (store.changeStatus(orderId, restId, target, o->version)) {
+        case StatusChange::Applied: break;
+        case StatusChange::NotAllowed:
+            std::cerr << "Order " << orderId << " cannot go from " << toString(o->status) << " to " << toString(target) << "\n";
+            return 1;
+        case StatusChange::Conflict:
+            o = store.find(orderId, restId);
+            std::cerr << "Order " << orderId << " was changed by another terminal (now " << (o ? toString(o->status) : "gone") << ")\n";
+            return 1;
+        case StatusChange::NotFound:
+            std::cerr << "No order " << orderId << " for restaurant " << restId << "\n";
+            return 1;
+        case StatusChange::WriteFailed:
+            std::cerr << "Could not write the status change\n";
+            return 1;
+    }
+    o = store.find(orderId, restId);
+    std::cout << o->id << "\t" << toString(o->status) << "\n";
+    return 0;
+}
+
+static int cmdVerify() {
+    static const char *const STATES[] = {"ok", "no checksum", "missing", "corrupt"};
+    for (const char *name : {"customers.txt", "owners.txt", "restaurants.txt", "orders.txt"})
+        std::cout << name << "\t" << STATES[(int)Persistence::checkDataFile(name)] << "\n";
+    std::vector<std::string> notes = Persistence::recoverDataFiles(); // also printed on stderr
+    return notes.empty() ? 0 : 1;
+}
+
+static int runCommand(const std::string &cmd, const std::vector<std::string> &args) {
+    try {
+        if (cmd == "orders") return cmdOrders(args);
+        if (cmd == "checkout") return cmdCheckout(args);
+        if (cmd == "batch") return cmdBatch(args);
+        if (cmd == "dispatch") return cmdStatus(args, OrderStatus::Dispatched);
+        if (cmd == "cancel") return cmdStatus(args, OrderStatus::Cancelled);
+        if (cmd == "status") {
+            OrderStatus target;
+            if (args.size() < 3 || !parseOrderStatus(args[2], target)) { printUsage(); return 2; }
+            return cmdStatus(args, target);
+        }
+        if (cmd == "compact") { Persistence::compactOrders(); return 0; }
+        if (cmd == "metrics") { std::cout << Metrics::prometheusText(); return 0; }
+        if (cmd == "verify") return cmdVerify();
+    } catch (const std::exception &e) {
+        std::cerr << cmd << ": invalid argument (" << e.what() << ")\n";
+        return 2;
+    }
+    printUsage();
+    return 2;
+}
+
+// Daemon mode: one command per line on stdin, "ok"/"err" acknowledgement on stdout
+static int serve() {
+    std::string line;
+    while (std::getline(std::cin, line)) {
+        std::istringstream iss(line);
+        std::string cmd, arg;
+        std::vector<std::string> args;
+        iss >> cmd;
+        if (cmd.empty()) continue;
+        if (cmd == "quit") break;
+        while (iss >> arg) args.push_back(arg);
+        std::cout << (runCommand(cmd, args) == 0 ? "ok" : "err") << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    std::string tracePath, metricsPath;
+    MetricsServer metricsServer;
+    while (args.size() >= 2 && args[0].rfind("--", 0) == 0) {
+        const std::string &opt = args[0], &value = args[1];
+        if (opt == "--data") {
+            Persistence::dataFolder = value;
+            if (!Persistence::dataFolder.empty() && Persistence::dataFolder.back() != '/') Persistence::dataFolder += '/';
+        } else if (opt == "--trace") {
+            tracePath = value;
+        } else if (opt == "--metrics") {
+            metricsPath = value;
+        } else if (opt == "--metrics-port") {
+            int port = std::atoi(value.c_str());
+            if (port <= 0 || !metricsServer.start(port)) return 1;
+        } else {
+            break; // a command option such as --discount
+        }
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.empty()) { printUsage(); return 2; }
+    if (!tracePath.empty()) Trace::startCapture();
+
+    std::string cmd = args[0];
+    args.erase(args.begin());
+    int rc = cmd == "serve" ? serve() : runCommand(cmd, args);
+    if (!tracePath.empty()) {
+        Trace::stopCapture();
+        if (!Trace::writeChromeTrace(tracePath)) return 1;
+    }
+    if (!metricsPath.empty() && !Metrics::writeFile(metricsPath)) return 1;
+    return rc;
+}
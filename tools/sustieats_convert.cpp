@@ -0,0 +1,43 @@
+// Converts the order table between the text format (orders.txt + orders.txt.log)
+// and the binary columnar snapshot (orders.bin).
+//
+//   sustieats_convert [--data DIR] txt2bin [orders.txt] [orders.bin]
+//   sustieats_convert [--data DIR] bin2txt [orders.bin] [orders.txt]
+//
+// File names are relative to the data folder, like everywhere else in Persistence.
+// bin2txt replays the target's orders.txt.log onto the binary snapshot before it
+// writes, so orders and status changes logged since that snapshot are kept.
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Persistence.hpp"
+#include "OrderSnapshot.hpp"
+
+int main(int argc, char **argv) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    if (args.size() >= 2 && args[0] == "--data") {
+        Persistence::dataFolder = args[1];
+        if (!Persistence::dataFolder.empty() && Persistence::dataFolder.back() != '/') Persistence::dataFolder += '/';
+        args.erase(args.begin(), args.begin() + 2);
+    }
+    if (args.empty() || (args[0] != "txt2bin" && args[0] != "bin2txt")) {
+        std::cerr << "usage: sustieats_convert [--data DIR] <txt2bin|bin2txt> [from] [to]\n";
+        return 2;
+    }
+
+    if (args[0] == "txt2bin") {
+        std::string from = args.size() > 1 ? args[1] : "orders.txt";
+        std::string to = args.size() > 2 ? args[2] : "orders.bin";
+        auto orders = Persistence::loadAllOrders(from);
+        if (!Persistence::saveOrdersBinary(orders, to)) { std::cerr << "Could not write " << to << "\n"; return 1; }
+        std::cout << "wrote " << orders.size() << " orders to " << Persistence::dataFolder << to << "\n";
+    } else {
+        std::string from = args.size() > 1 ? args[1] : "orders.bin";
+        std::string to = args.size() > 2 ? args[2] : "orders.txt";
+        OrderSnapshotView view;
+        if (!view.open(Persistence::dataFolder + from)) return 1;
+        Persistence::restoreOrders(Persistence::loadOrdersBinary(from), to);
+        std::cout << "wrote " << Persistence::loadOrderSnapshot(to).size() << " orders to " << Persistence::dataFolder << to << "\n";
+    }
+    return 0;
+}